@@ -0,0 +1,413 @@
+/*
+eRCaGuy_LatencyProbe
+-measures interrupt latency: how long after an event an ISR actually gets to read the time.  When measuring pulses, this, not
+ the 0.5us count, is usually the biggest error: a pin change ISR can't read get_count() until whatever ISR (or noInterrupts()
+ section) is running when the edge arrives has finished.
+-how: a probe sets a timer's output compare match for a known count, & the compare match ISR reads TCNT as the very first
+ thing it does; how late it is (in counts) is exactly the latency ANY ISR would have seen at that moment, from the same causes
+ (other ISRs, & code running with interrupts off).  Probes are taken at random times, 1 at a time, at a rate you choose, from
+ service() in loop().
+-each probe is added to the statistics of the current "source", a label you choose for what the sketch is doing at the time (ex:
+ "idle", "Serial printing", "Servo running"), so the latency each activity causes can be compared side by side: # of probes,
+ min, max, mean, percentiles, & a histogram with 1 count per bucket
+-record() adds a latency you measured yourself to a source, ex: from your own ISR, if you know when its event really happened
+-a probe which hasn't gone off MISSED_OVERFLOWS (3) overflows after it was set (ex: because something else turned its compare match interrupt off)
+ is given up on, counted (get_missed_count()), & a new one is set, so the probe can't go silent.  Overflows are counted by the
+ overflow ISR, so this doesn't happen while it's off, ex: in tickless mode (eRCaGuy_TimerCounter_Tickless.h).
+-the fixed part of the latency (the minimum) can be subtracted from captured timestamps, with set_correction() or
+ set_correction_to_min(), & correct()
+-all statistics live in a table sized at compile time, so RAM use is fixed & known:
+   NUM_SOURCES*(18 + 2*NUM_BUCKETS) + 17 bytes
+ ex: LatencyProbe<4> uses 4*(18 + 2*32) + 17 = 345 bytes
+
+Basic usage:
+  #include <eRCaGuy_Timer2_Counter.h>
+  #include <eRCaGuy_LatencyProbe.h>
+
+  enum { SOURCE_IDLE, SOURCE_SERIAL, NUM_SOURCES };
+  LatencyProbe<NUM_SOURCES> probe; //Timer2, prescaler 8, output compare channel B
+  LATENCY_PROBE_ISR(probe, 2, B); //creates ISR(TIMER2_COMPB_vect) for it; put this at global scope, once
+
+  void setup() { timer2.setup(); probe.start(SOURCE_IDLE); }
+  void loop()
+  {
+    probe.service(); //call often
+    ...probe.set_source(SOURCE_SERIAL) before printing, etc.
+    if (time to print) probe.dump(Serial);
+  }
+
+What is & isn't measured:
+-each latency includes a fixed part, the same for every probe: the compare match flag being set 1 count after OCRnx, the
+ interrupt response, & the probe ISR's own register pushes before it reads TCNT.  That's the minimum you'll see (~4 to 6 counts
+ @ 0.5us/count); anything above it was caused by something else.
+-the probe ISR has a lower priority (higher vector #) than the pin change & external interrupts, so it sees every delay THEY
+ would see from code running with interrupts off & from ISRs already running, but not the (rare) case of 2 interrupts becoming
+ pending at the same moment.
+-latencies of 2^COUNTER_BITS counts (128us on Timer2 @ prescaler 8) or more can't be told apart from shorter ones; anything that
+ long would also lose overflows.
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#ifndef eRCaGuy_LatencyProbe_h
+#define eRCaGuy_LatencyProbe_h
+
+#include "eRCaGuy_TimerCounter.h"
+#include "eRCaGuy_TimerCounter_Durations.h"
+
+//Define the compare match ISR for a LatencyProbe object.  Use it once, at global scope, ex: LATENCY_PROBE_ISR(probe, 2, B);
+//-TIMER_ID & CHANNEL_LETTER (A or B) must match the probe's COUNTER & CHANNEL; this is checked at compile time
+#define LATENCY_PROBE_ISR(probe, TIMER_ID, CHANNEL_LETTER) \
+  ISR(TIMER_COUNTER_COMPARE_VECT(TIMER_ID, CHANNEL_LETTER)) \
+  { \
+    static_assert(decltype(probe)::TIMER_ID_VALUE == TIMER_ID && \
+                  decltype(probe)::CHANNEL_VALUE == TIMER_COUNTER_CHANNEL_##CHANNEL_LETTER, \
+                  "LATENCY_PROBE_ISR: the timer & channel must match the probe's COUNTER & CHANNEL"); \
+    probe.on_compare_match(); \
+  }
+
+//-NUM_SOURCES: the # of sources (labels) to keep separate statistics for
+//-COUNTER: the TimerCounter to probe; its setup() must be called first
+//-CHANNEL: the output compare channel to use, TIMER_COUNTER_CHANNEL_A or TIMER_COUNTER_CHANNEL_B (the default, so channel A is
+// left free for a TimerScheduler)
+//-NUM_BUCKETS: histogram buckets, 1 count wide each, 2 to 255; the last one also counts everything longer
+template <uint8_t NUM_SOURCES, typename COUNTER = TimerCounter<2,8>, uint8_t CHANNEL = TIMER_COUNTER_CHANNEL_B,
+          uint8_t NUM_BUCKETS = 32>
+class LatencyProbe
+{
+  static_assert(NUM_SOURCES >= 1, "LatencyProbe: NUM_SOURCES must be at least 1");
+  static_assert(NUM_BUCKETS >= 2 && NUM_BUCKETS <= 255, "LatencyProbe: NUM_BUCKETS must be 2 to 255");
+
+  private:
+    typedef TimerCounterRegs<COUNTER::TIMER_ID_VALUE> Regs;
+    typedef TimerCounterCompare<COUNTER::TIMER_ID_VALUE, CHANNEL> Compare;
+    typedef TimerCounterState<COUNTER::TIMER_ID_VALUE> State;
+    typedef typename Regs::count_t count_t;
+
+  public:
+    static const uint8_t TIMER_ID_VALUE = COUNTER::TIMER_ID_VALUE;
+    static const uint8_t CHANNEL_VALUE = CHANNEL;
+    //a probe which hasn't gone off this many overflows after being set is given up on; it goes off < 1 overflow period after
+    //being set, so by then it's > 1 period late
+    static const uint8_t MISSED_OVERFLOWS = 3;
+
+    struct Stats
+    {
+      uint32_t count; //# of latencies recorded
+      uint16_t min; //counts
+      uint16_t max; //counts
+      uint64_t sum; //counts; sum/count = mean
+      uint16_t histogram[NUM_BUCKETS]; //histogram[n] = # of latencies of n counts; when a bucket fills up, all of them are halved
+    };
+
+    LatencyProbe() : _running(false), _armed(false), _source(0), _target(0), _armed_overflow(0), _interval(0), _next_probe(0),
+                     _rng(0xACE1), _missed_count(0)
+    {
+      reset();
+      for (uint8_t source = 0; source < NUM_SOURCES; source++)
+        _correction[source] = 0;
+    }
+
+    //start probing, adding the results to "source"; about 1 probe every "interval" counts (the default is 1ms), each at a random
+    //time within its interval, so that probes don't lock onto the timing of other periodic ISRs
+    void start(uint8_t source, uint32_t interval = COUNTER::COUNTS_PER_SECOND/1000)
+    {
+      _source = source < NUM_SOURCES ? source : NUM_SOURCES - 1;
+      _interval = interval;
+      _next_probe = COUNTER::get_count();
+      _running = true;
+    }
+
+    //stop probing; a probe already set still completes
+    inline void stop() { _running = false; }
+
+    inline bool is_running() const { return _running; }
+
+    //add the probes from now on to "source" instead
+    void set_source(uint8_t source)
+    {
+      uint8_t SREG_old = SREG;
+      cli();
+      _source = source < NUM_SOURCES ? source : NUM_SOURCES - 1;
+      SREG = SREG_old;
+    }
+
+    inline uint8_t get_source() const { return _source; }
+
+    //set the next probe, when it's time; call often, ex: every loop()
+    void service()
+    {
+      if (_armed)
+      {
+        //while a probe is set, only 1 byte is read here, with interrupts left on, so service() itself doesn't delay the probe
+        if ((uint8_t)((uint8_t)State::overflow_count - _armed_overflow) < MISSED_OVERFLOWS)
+          return;
+        give_up_probe();
+      }
+      if (!_running)
+        return;
+      uint8_t SREG_old = SREG;
+      cli();
+      uint32_t now = COUNTER::get_count_in_isr();
+      if (!_armed && (int32_t)(now - _next_probe) >= 0)
+      {
+        //the probe goes off 16 to 143 counts from now: far enough that the compare register is set well before then, & within 1
+        //overflow period, so that the match can't happen a period early
+        uint32_t target = now + 16 + (next_random() & 0x7F);
+        _target = (count_t)target;
+        Compare::ocr() = (count_t)(target - 1); //OCFnx is set as TCNTn counts from OCRnx to OCRnx + 1
+        Compare::clear_flag(); //after writing OCRnx, so a match on the old value can't fire a probe
+        Compare::interrupt_on();
+        _armed = true;
+        _armed_overflow = (uint8_t)State::overflow_count; //after get_count_in_isr(), so it includes a pending overflow
+        //random probe times, but on average 1 per interval: the next one is set 0 to 2*spread counts (spread on average) after
+        //this one goes off, & goes off on average 79.5 counts after that
+        uint32_t spread = _interval > 80 ? _interval - 80 : 0;
+        if (spread <= 0x7FFF)
+          _next_probe = target + next_random() % (2*spread + 1);
+        else
+          _next_probe = target + (spread - 0x7FFF) + next_random(); //as wide a spread as 16 random bits allow
+      }
+      SREG = SREG_old;
+    }
+
+    //called by the compare match ISR (see LATENCY_PROBE_ISR); interrupts must be off
+    inline void on_compare_match()
+    {
+      count_t tcnt = Regs::tcnt(); //FIRST, before anything else
+      Compare::interrupt_off(); //1 match per probe
+      _armed = false;
+      record_in_isr(_source, (count_t)(tcnt - _target));
+    }
+
+    //add one latency, in counts, to a source's statistics
+    void record(uint8_t source, uint16_t latency)
+    {
+      uint8_t SREG_old = SREG;
+      cli();
+      record_in_isr(source, latency);
+      SREG = SREG_old;
+    }
+
+    //copy out one source's statistics
+    void get_stats(uint8_t source, Stats& stats) const
+    {
+      uint8_t SREG_old = SREG;
+      cli();
+      stats = _stats[source];
+      SREG = SREG_old;
+    }
+
+    //the latency, in counts, which "per_mille" thousandths of a source's latencies are at or below, ex: percentile(source, 990)
+    //is the 99th percentile.  Latencies in the last histogram bucket are reported as the max.
+    uint16_t percentile(uint8_t source, uint16_t per_mille) const
+    {
+      Stats stats;
+      get_stats(source, stats);
+      return percentile(stats, per_mille);
+    }
+
+    static uint16_t percentile(const Stats& stats, uint16_t per_mille)
+    {
+      uint32_t total = 0;
+      for (uint8_t bucket = 0; bucket < NUM_BUCKETS; bucket++)
+        total += stats.histogram[bucket];
+      if (total == 0)
+        return 0;
+      //total*per_mille/1000, rounded up, so percentile(..., 1000) is the max; split so it can't overflow 32 bits, since total can
+      //be up to 255*65535 (every bucket full)
+      uint32_t threshold = total/1000*per_mille + (total % 1000*per_mille + 999)/1000;
+      if (threshold == 0)
+        threshold = 1;
+      uint32_t cumulative = 0;
+      for (uint8_t bucket = 0; bucket < NUM_BUCKETS - 1; bucket++)
+      {
+        cumulative += stats.histogram[bucket];
+        if (cumulative >= threshold)
+          return bucket;
+      }
+      return stats.max;
+    }
+
+    //# of probes given up on because they hadn't gone off MISSED_OVERFLOWS overflows after being set, ex: because something else
+    //turned the compare match interrupt off (saturates at 65535); not counted in any source's statistics
+    inline uint16_t get_missed_count() const { return _missed_count; } //only changed by service() & reset(), not by the ISR
+
+    //clear every source's statistics & the missed count (but not the corrections)
+    void reset()
+    {
+      uint8_t SREG_old = SREG;
+      cli();
+      _missed_count = 0;
+      for (uint8_t source = 0; source < NUM_SOURCES; source++)
+      {
+        Stats& stats = _stats[source];
+        stats.count = 0;
+        stats.min = 0;
+        stats.max = 0;
+        stats.sum = 0;
+        for (uint8_t bucket = 0; bucket < NUM_BUCKETS; bucket++)
+          stats.histogram[bucket] = 0;
+      }
+      SREG = SREG_old;
+    }
+
+    //-----------------------------------------------------------------------------------------------
+    //Latency correction: a fixed # of counts per source, subtracted from timestamps captured under it, ex: in a pin change ISR,
+    //t = probe.correct(SOURCE_IDLE, timer2.get_count_in_isr()); so that t is closer to when the edge really happened.  Only the
+    //fixed part of the latency can be corrected this way; the varying part is what the histograms show.
+    //-----------------------------------------------------------------------------------------------
+    inline void set_correction(uint8_t source, uint16_t counts) { _correction[source] = counts; }
+    inline uint16_t get_correction(uint8_t source) const { return _correction[source]; }
+    //set a source's correction to the minimum of its measured latencies: the fixed part (see "What is & isn't measured" above)
+    void set_correction_to_min(uint8_t source)
+    {
+      Stats stats;
+      get_stats(source, stats);
+      _correction[source] = stats.min;
+    }
+    inline uint32_t correct(uint8_t source, uint32_t timestamp) const { return timestamp - _correction[source]; }
+
+    #if defined(ARDUINO)
+    //print every source's statistics, in counts & us; names (optional) is an array of NUM_SOURCES source names
+    void dump(Print& out, const char* const* names = 0) const
+    {
+      typedef TimerCounterTicks<COUNTER> ticks_t;
+      for (uint8_t source = 0; source < NUM_SOURCES; source++)
+      {
+        Stats stats;
+        get_stats(source, stats);
+        if (names)
+          out.print(names[source]);
+        else
+        {
+          out.print(F("source ")); out.print(source);
+        }
+        out.print(F(": probes = ")); out.print(stats.count);
+        if (stats.count == 0)
+        {
+          out.println();
+          continue;
+        }
+        out.print(F(", latency (counts): min = ")); out.print(stats.min);
+        //mean to 2 decimal places, with integer math only
+        out.print(F(", mean = ")); print_fixed(out, (uint32_t)(stats.sum/stats.count),
+                                               (uint32_t)(stats.sum % stats.count*100/stats.count), 2);
+        out.print(F(", p50 = ")); out.print(percentile(stats, 500));
+        out.print(F(", p90 = ")); out.print(percentile(stats, 900));
+        out.print(F(", p99 = ")); out.print(percentile(stats, 990));
+        out.print(F(", max = ")); out.print(stats.max);
+        uint32_t max_ns = ticks_t(stats.max).to_nanos().value;
+        out.print(F(" (")); print_fixed(out, max_ns/1000, max_ns % 1000, 3); out.println(F(" us)"));
+        out.print(F("  histogram (1 count per bucket): "));
+        for (uint8_t bucket = 0; bucket < NUM_BUCKETS; bucket++)
+        {
+          out.print(stats.histogram[bucket]);
+          out.print(bucket < NUM_BUCKETS - 1 ? F(" ") : F("\n"));
+        }
+      }
+      out.print(F("missed probes = ")); out.println(get_missed_count());
+    }
+    #endif
+
+  private:
+    //a probe was set, but never went off; turn it off & count it, so service() sets a new one
+    void give_up_probe()
+    {
+      uint8_t SREG_old = SREG;
+      cli();
+      if (_armed) //it may have gone off just now, after all
+      {
+        Compare::interrupt_off();
+        _armed = false;
+        if (_missed_count != 0xFFFF) //saturate rather than roll over to 0
+          _missed_count++;
+        _next_probe = COUNTER::get_count_in_isr(); //set a new one right away
+      }
+      SREG = SREG_old;
+    }
+
+    //a 16-bit xorshift random #
+    inline uint16_t next_random()
+    {
+      _rng ^= _rng << 7;
+      _rng ^= _rng >> 9;
+      _rng ^= _rng << 8;
+      return _rng;
+    }
+
+    #if defined(ARDUINO)
+    //print whole.fraction, with the fraction zero-padded to "digits" digits, ex: (3, 5, 2) --> "3.05"
+    static void print_fixed(Print& out, uint32_t whole, uint32_t fraction, uint8_t digits)
+    {
+      out.print(whole);
+      out.print('.');
+      uint32_t place = 1; //10^(digits - 1)
+      for (; digits > 1; digits--)
+        place *= 10;
+      for (; place > 1 && fraction < place; place /= 10)
+        out.print('0');
+      out.print(fraction);
+    }
+    #endif
+
+    //interrupts must be off
+    void record_in_isr(uint8_t source, uint16_t latency)
+    {
+      if (source >= NUM_SOURCES)
+        return;
+      Stats& stats = _stats[source];
+      if (stats.count == 0 || latency < stats.min)
+        stats.min = latency;
+      if (latency > stats.max)
+        stats.max = latency;
+      stats.count++;
+      stats.sum += latency;
+      uint8_t bucket = latency < NUM_BUCKETS - 1 ? latency : NUM_BUCKETS - 1;
+      if (stats.histogram[bucket] == 0xFFFF)
+      {
+        //halve them all, so the percentiles stay right, rather than letting this one bucket saturate
+        for (uint8_t i = 0; i < NUM_BUCKETS; i++)
+          stats.histogram[i] >>= 1;
+      }
+      stats.histogram[bucket]++;
+    }
+
+    Stats _stats[NUM_SOURCES];
+    uint16_t _correction[NUM_SOURCES]; //counts
+    volatile bool _running;
+    volatile bool _armed; //a probe is set & hasn't gone off yet
+    volatile uint8_t _source;
+    count_t _target; //the count at which the probe's compare match flag is set
+    uint8_t _armed_overflow; //low byte of the overflow count when the probe was set
+    uint32_t _interval;
+    uint32_t _next_probe; //the count at which service() sets the next probe
+    uint16_t _rng; //a 16-bit xorshift random # generator, for the probe times
+    uint16_t _missed_count; //probes given up on; see get_missed_count()
+};
+
+#endif
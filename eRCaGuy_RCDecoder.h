@@ -0,0 +1,397 @@
+/*
+eRCaGuy_RCDecoder
+-decodes Radio Control (RC) receiver signals on ANY pins, using pin change interrupts & a TimerCounter for 0.5us timestamps:
+--PwmDecoder: up to 8 separate servo-type PWM channels (one pin per channel), ex: all 8 channels of an 8-ch receiver
+--PpmDecoder: a PPM (CPPM) stream carrying up to 8 (or more) channels on a single pin
+
+Why it is fast enough to read a whole receiver:
+-each pin change ISR reads its port (PINB, PINC, or PIND) ONCE, & XORs that snapshot against the previous one to find EVERY pin on
+ that port which changed, & timestamps them all with ONE get_count() call.  So edges which arrive together (ex: the end of ch 1 &
+ the start of ch 2, which many receivers output at the same instant) cost one ISR, not one ISR per pin, & all get the same time.
+-the per-channel state is kept as a "struct of arrays" (all rise times together, all pulse widths together, etc.), indexed by
+ channel number, using 16-bit times, so each update is a couple of 16-bit loads & stores.
+
+Basic usage (see the examples for more):
+  #include <eRCaGuy_Timer2_Counter.h>
+  #include <eRCaGuy_RCDecoder.h>
+  PwmDecoder<8> rx; //8 channels, timed by Timer2 (the "timer2" object's timer)
+  RC_DECODER_PCINT_ISR(0, rx) //PCINT0_vect: pins D8 to D13
+  RC_DECODER_PCINT_ISR(2, rx) //PCINT2_vect: pins D0 to D7
+
+  void setup()
+  {
+    timer2.setup();
+    rx.attach(0, 2); //ch 0 on pin 2
+    rx.attach(1, 3); //ch 1 on pin 3, etc.
+  }
+  void loop()
+  {
+    uint8_t new_data = rx.get_new_data(); //bit n set = ch n has a new pulse width since last time
+    uint16_t width = rx.get_pulse_width(0); //units of 0.5us, ex: 3000 = 1500us
+  }
+
+Notes:
+-written for the ATmega328 (Uno, Nano, Pro Mini, etc.), whose pin change interrupt "ports" are: 0 = PCINT0_vect = PORTB = D8 to D13,
+ 1 = PCINT1_vect = PORTC = A0 to A5, & 2 = PCINT2_vect = PORTD = D0 to D7.  See datasheet pgs. 73-75.
+-the same RC_DECODER_PCINT_ISR can't be used for 2 decoders; if you need both a PwmDecoder & a PpmDecoder, put them on different
+ ports, or write the ISR yourself & call both decoders' on_pin_change() from it.
+-times are stored as uint16_t by default, so pulse widths & periods must be < 65536 counts (32.767ms @ 0.5us/count).  RC PWM
+ (~1000~2000us, every ~20ms) & PPM are well within that.  For longer pulses use TIME_T = uint32_t.
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#ifndef eRCaGuy_RCDecoder_h
+#define eRCaGuy_RCDecoder_h
+
+#include "eRCaGuy_TimerCounter.h"
+
+//---------------------------------------------------------------------------------------------------
+//Pin change interrupt plumbing shared by both decoders
+//---------------------------------------------------------------------------------------------------
+struct RCDecoderPcint
+{
+  static const uint8_t NUM_PORTS = 3;
+  static const uint8_t NO_CHANNEL = 0xFF;
+
+  //read a whole port; port is a constant in each ISR, so once inlined this is a single "in" instruction
+  static inline uint8_t read_port(uint8_t port)
+  {
+    return port == 0 ? PINB : port == 1 ? PINC : PIND;
+  }
+
+  //enable the pin change interrupt for one bit of one port; see datasheet pgs. 73-75
+  static inline void enable(uint8_t port, uint8_t bit)
+  {
+    uint8_t SREG_old = SREG;
+    cli();
+    if (port == 0)
+      PCMSK0 |= _BV(bit);
+    else if (port == 1)
+      PCMSK1 |= _BV(bit);
+    else
+      PCMSK2 |= _BV(bit);
+    PCICR |= _BV(port);
+    SREG = SREG_old;
+  }
+
+  #if defined(ARDUINO)
+  //map an Arduino pin number to its pin change port & bit, using the core's macros (see pins_arduino.h); returns false for pins
+  //which have no pin change interrupt, ex: A6 & A7
+  static inline bool pin_to_port_bit(uint8_t pin, uint8_t& port, uint8_t& bit)
+  {
+    if (digitalPinToPCICR(pin) == 0)
+      return false;
+    port = digitalPinToPCICRbit(pin);
+    bit = digitalPinToPCMSKbit(pin);
+    return port < NUM_PORTS;
+  }
+  #endif
+};
+
+//Define ISR(PCINT<port>_vect) to call decoder.on_pin_change(port); use it once per port used, at global scope.
+#define RC_DECODER_PCINT_ISR(port, decoder) \
+  ISR(PCINT##port##_vect) \
+  { \
+    decoder.on_pin_change(port); \
+  }
+
+//---------------------------------------------------------------------------------------------------
+//PwmDecoder: one servo-type PWM channel per pin
+//---------------------------------------------------------------------------------------------------
+template <uint8_t NUM_CHANNELS, typename COUNTER = TimerCounter<2,8>, typename TIME_T = uint16_t>
+class PwmDecoder
+{
+  static_assert(NUM_CHANNELS >= 1 && NUM_CHANNELS <= 8, "PwmDecoder: NUM_CHANNELS must be 1 to 8");
+
+  public:
+    PwmDecoder() : _have_rise(0), _new_data(0)
+    {
+      for (uint8_t port = 0; port < RCDecoderPcint::NUM_PORTS; port++)
+      {
+        _port_state[port] = 0;
+        _port_mask[port] = 0;
+        for (uint8_t bit = 0; bit < 8; bit++)
+          _channel_of[port][bit] = RCDecoderPcint::NO_CHANNEL;
+      }
+      for (uint8_t ch = 0; ch < NUM_CHANNELS; ch++)
+      {
+        _rise_time[ch] = 0;
+        _pulse_width[ch] = 0;
+        _period[ch] = 0;
+      }
+    }
+
+    //read channel "channel" on pin change port "port" (0, 1, or 2), bit "bit" (0 to 7), & enable that pin's interrupt; the pin
+    //must already be an input.  Returns false if the arguments are out of range.
+    bool attach_port_bit(uint8_t channel, uint8_t port, uint8_t bit)
+    {
+      if (channel >= NUM_CHANNELS || port >= RCDecoderPcint::NUM_PORTS || bit > 7)
+        return false;
+      uint8_t SREG_old = SREG;
+      cli();
+      _channel_of[port][bit] = channel;
+      _port_mask[port] |= _BV(bit);
+      //start from this pin's current state, so it isn't seen as an edge; only this bit is updated, so an edge still pending on
+      //another channel of the same port isn't lost
+      _port_state[port] = (_port_state[port] & ~_BV(bit)) | (RCDecoderPcint::read_port(port) & _BV(bit));
+      _have_rise &= ~_BV(channel); //wait for a real rising edge before timing anything
+      SREG = SREG_old;
+      RCDecoderPcint::enable(port, bit);
+      return true;
+    }
+
+    #if defined(ARDUINO)
+    //same as above, but by Arduino pin number, ex: attach(0, A0); also sets pinMode(pin, INPUT)
+    bool attach(uint8_t channel, uint8_t pin)
+    {
+      uint8_t port, bit;
+      if (!RCDecoderPcint::pin_to_port_bit(pin, port, bit))
+        return false;
+      pinMode(pin, INPUT);
+      return attach_port_bit(channel, port, bit);
+    }
+    #endif
+
+    //call from ISR(PCINT<port>_vect), ex: via RC_DECODER_PCINT_ISR(); port should be a constant
+    inline void on_pin_change(uint8_t port)
+    {
+      TIME_T t = (TIME_T)COUNTER::get_count_in_isr(); //ONE timestamp for every edge seen in this ISR; take it first
+      uint8_t state = RCDecoderPcint::read_port(port); //ONE snapshot of the whole port
+      uint8_t changed = (state ^ _port_state[port]) & _port_mask[port];
+      _port_state[port] = state;
+      for (uint8_t bit = 0; changed != 0; bit++, changed >>= 1, state >>= 1)
+      {
+        if (!(changed & 1))
+          continue;
+        uint8_t ch = _channel_of[port][bit];
+        if (state & 1) //rising edge: start of a pulse
+        {
+          if (_have_rise & _BV(ch)) //no period until the 2nd rising edge
+            _period[ch] = t - _rise_time[ch];
+          _rise_time[ch] = t;
+          _have_rise |= _BV(ch);
+        }
+        else if (_have_rise & _BV(ch)) //falling edge: end of a pulse (ignored until a rising edge has been seen)
+        {
+          _pulse_width[ch] = t - _rise_time[ch];
+          _new_data |= _BV(ch);
+        }
+      }
+    }
+
+    //bit n is set if channel n has received a new pulse since the last call; the bits are cleared
+    uint8_t get_new_data()
+    {
+      uint8_t SREG_old = SREG;
+      cli();
+      uint8_t new_data = _new_data;
+      _new_data = 0;
+      SREG = SREG_old;
+      return new_data;
+    }
+
+    //most recent high pulse width, in counts (0.5us for a prescaler of 8 @ 16MHz); 0 until a whole pulse has been seen
+    TIME_T get_pulse_width(uint8_t channel) const
+    {
+      return read_atomic(_pulse_width[channel]);
+    }
+
+    //most recent time between rising edges, in counts; 0 until 2 rising edges have been seen
+    TIME_T get_period(uint8_t channel) const
+    {
+      return read_atomic(_period[channel]);
+    }
+
+  private:
+    static inline TIME_T read_atomic(const volatile TIME_T& value)
+    {
+      uint8_t SREG_old = SREG;
+      cli();
+      TIME_T copy = value;
+      SREG = SREG_old;
+      return copy;
+    }
+
+    //per-port state, indexed by pin change port
+    uint8_t _port_state[RCDecoderPcint::NUM_PORTS]; //last snapshot of each port
+    uint8_t _port_mask[RCDecoderPcint::NUM_PORTS]; //which bits of each port are attached
+    uint8_t _channel_of[RCDecoderPcint::NUM_PORTS][8]; //channel # for each port bit, or NO_CHANNEL
+    //per-channel state, indexed by channel ("struct of arrays")
+    TIME_T _rise_time[NUM_CHANNELS]; //only used in the ISR
+    uint8_t _have_rise; //bit n set = _rise_time[n] holds a real rising edge; only used in the ISR (& attach_port_bit(), with
+                        //interrupts off)
+    volatile TIME_T _pulse_width[NUM_CHANNELS];
+    volatile TIME_T _period[NUM_CHANNELS];
+    volatile uint8_t _new_data; //bit n set = new pulse width on channel n
+};
+
+//---------------------------------------------------------------------------------------------------
+//PpmDecoder: a PPM (CPPM) stream on a single pin
+//-in PPM, each channel's value is the time from one (rising) edge to the next; a long gap (the "sync gap", typically > ~3ms)
+// marks the end of each frame, so the next edge starts channel 0 again.
+//-each complete frame is copied to a second buffer, so loop() always reads a whole, consistent frame.
+//---------------------------------------------------------------------------------------------------
+template <uint8_t MAX_CHANNELS, typename COUNTER = TimerCounter<2,8>, typename TIME_T = uint16_t>
+class PpmDecoder
+{
+  static_assert(MAX_CHANNELS >= 1 && MAX_CHANNELS < 0xFF,
+                "PpmDecoder: MAX_CHANNELS must be 1 to 254 (0xFF marks \"waiting for the sync gap\")");
+
+  public:
+    //the default sync gap of 2.5ms is longer than any channel (max ~2.1ms) & shorter than any normal frame's sync gap
+    static const TIME_T DEFAULT_SYNC_GAP = (TIME_T)(COUNTER::COUNTS_PER_SECOND/400); //2.5ms in counts
+    static const uint8_t DEFAULT_MIN_CHANNELS = 4; //frames with fewer channels than this are discarded as noise
+
+    //rising_edges: true to time rising edge to rising edge (most receivers), false for falling edges (inverted PPM)
+    PpmDecoder(TIME_T sync_gap = DEFAULT_SYNC_GAP, uint8_t min_channels = DEFAULT_MIN_CHANNELS, bool rising_edges = true) :
+      _sync_gap(sync_gap), _min_channels(min_channels), _edge_level(rising_edges ? 0xFF : 0), _port(0), _bit_mask(0),
+      _port_state(0), _last_edge(0), _channel_index(0xFF), _num_channels(0), _frame_count(0), _new_frame(false)
+    {
+      for (uint8_t ch = 0; ch < MAX_CHANNELS; ch++)
+      {
+        _channels_in[ch] = 0;
+        _channels[ch] = 0;
+      }
+    }
+
+    //read the PPM stream on pin change port "port" (0, 1, or 2), bit "bit" (0 to 7), & enable that pin's interrupt
+    bool attach_port_bit(uint8_t port, uint8_t bit)
+    {
+      if (port >= RCDecoderPcint::NUM_PORTS || bit > 7)
+        return false;
+      uint8_t SREG_old = SREG;
+      cli();
+      _port = port;
+      _bit_mask = _BV(bit);
+      _port_state = RCDecoderPcint::read_port(port) & _bit_mask;
+      SREG = SREG_old;
+      RCDecoderPcint::enable(port, bit);
+      return true;
+    }
+
+    #if defined(ARDUINO)
+    //same as above, but by Arduino pin number; also sets pinMode(pin, INPUT)
+    bool attach(uint8_t pin)
+    {
+      uint8_t port, bit;
+      if (!RCDecoderPcint::pin_to_port_bit(pin, port, bit))
+        return false;
+      pinMode(pin, INPUT);
+      return attach_port_bit(port, bit);
+    }
+    #endif
+
+    //call from ISR(PCINT<port>_vect), ex: via RC_DECODER_PCINT_ISR()
+    inline void on_pin_change(uint8_t port)
+    {
+      TIME_T t = (TIME_T)COUNTER::get_count_in_isr();
+      uint8_t state = RCDecoderPcint::read_port(port) & _bit_mask;
+      if (port != _port || state == _port_state) //another pin on this port changed, not ours
+        return;
+      _port_state = state;
+      if ((state ^ _edge_level) & _bit_mask) //not the edge we time from
+        return;
+      on_edge(t);
+    }
+
+    //process one timing edge at time t (counts); on_pin_change() calls this, or call it yourself from your own ISR
+    inline void on_edge(TIME_T t)
+    {
+      TIME_T gap = t - _last_edge;
+      _last_edge = t;
+      if (gap >= _sync_gap) //sync gap: end of a frame
+      {
+        if (_channel_index != 0xFF && _channel_index >= _min_channels) //a complete frame; publish it
+        {
+          for (uint8_t ch = 0; ch < _channel_index; ch++)
+            _channels[ch] = _channels_in[ch];
+          _num_channels = _channel_index;
+          _frame_count++;
+          _new_frame = true;
+        }
+        _channel_index = 0;
+      }
+      else if (_channel_index < MAX_CHANNELS) //a channel
+      {
+        _channels_in[_channel_index++] = gap;
+      }
+      else if (_channel_index != 0xFF) //more channels than MAX_CHANNELS: drop this frame, & wait for the next sync gap
+      {
+        _channel_index = 0xFF;
+      }
+    }
+
+    //true if a new frame has arrived since the last call to get_frame()
+    inline bool new_frame() const
+    {
+      return _new_frame;
+    }
+
+    //copy the most recent complete frame into channels[] (which must hold MAX_CHANNELS values), in counts; returns the # of
+    //channels in it (0 if none received yet)
+    uint8_t get_frame(TIME_T* channels)
+    {
+      uint8_t SREG_old = SREG;
+      cli();
+      uint8_t num_channels = _num_channels;
+      for (uint8_t ch = 0; ch < num_channels; ch++)
+        channels[ch] = _channels[ch];
+      _new_frame = false;
+      SREG = SREG_old;
+      return num_channels;
+    }
+
+    //total # of complete frames received (wraps at 65536)
+    uint16_t get_frame_count() const
+    {
+      uint8_t SREG_old = SREG;
+      cli();
+      uint16_t frame_count = _frame_count;
+      SREG = SREG_old;
+      return frame_count;
+    }
+
+  private:
+    const TIME_T _sync_gap;
+    const uint8_t _min_channels;
+    const uint8_t _edge_level; //0xFF = time rising edges, 0 = falling edges
+    uint8_t _port;
+    uint8_t _bit_mask;
+    uint8_t _port_state; //last state of our pin, masked
+    //ISR-only
+    TIME_T _last_edge;
+    uint8_t _channel_index; //channel the next gap belongs to; 0xFF = waiting for a sync gap
+    TIME_T _channels_in[MAX_CHANNELS]; //frame being received
+    //published to loop()
+    volatile TIME_T _channels[MAX_CHANNELS];
+    volatile uint8_t _num_channels;
+    volatile uint16_t _frame_count;
+    volatile bool _new_frame;
+};
+
+#endif
@@ -0,0 +1,237 @@
+/*
+eRCaGuy_SectionProfiler
+-a tiny profiler for finding where the time goes in a running sketch, without a debugger & without any dynamic memory allocation
+-mark a section of code as a "zone" (either with a scoped object, or a begin/end macro pair); every time it runs, its duration,
+ measured with get_count(), is added to that zone's statistics: # of runs, min, max, running sum (--> mean), & a histogram
+-all statistics live in a table sized at compile time (NUM_ZONES zones), so RAM use is fixed & known:
+   NUM_ZONES*(20 + 2*NUM_BUCKETS) bytes, + 1
+ ex: SectionProfiler<8> uses 8*(20 + 2*16) + 1 = 417 bytes
+-the cost of get_count() itself, measured by calibrate(), is subtracted from every duration
+-dump() prints everything, on demand
+
+Basic usage:
+  #include <eRCaGuy_Timer2_Counter.h>
+  #include <eRCaGuy_SectionProfiler.h>
+
+  enum { ZONE_READ_SENSORS, ZONE_FILTER, NUM_ZONES };
+  typedef SectionProfiler<NUM_ZONES> Profiler;
+
+  void setup() { timer2.setup(); Profiler::calibrate(); }
+  void loop()
+  {
+    {
+      PROFILE_SCOPE(Profiler, ZONE_READ_SENSORS); //times from here to the end of this { } block
+      readSensors();
+    }
+    PROFILE_BEGIN(Profiler, ZONE_FILTER);
+    filter();
+    PROFILE_END(Profiler, ZONE_FILTER);
+    if (time to print) Profiler::dump(Serial);
+  }
+
+Histogram: bucket 0 counts durations of 0 counts, & bucket b (b >= 1) counts durations from 2^(b-1) to 2^b - 1 counts; the last
+bucket also counts everything longer.  With 0.5us counts & 16 buckets, that's 0.5us, 1us, 2us, ... up to >= 8.192ms.
+
+Zones may be used both in loop() & in ISRs; the statistics are updated with interrupts off (for ~a few us), so each update is
+consistent.
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#ifndef eRCaGuy_SectionProfiler_h
+#define eRCaGuy_SectionProfiler_h
+
+#include "eRCaGuy_TimerCounter.h"
+#include "eRCaGuy_TimerCounter_Durations.h"
+
+//time from here to the end of the enclosing { } block, as zone "zone"
+#define PROFILE_SCOPE(Profiler, zone) Profiler::Scope profile_scope_##zone(zone)
+
+//time from PROFILE_BEGIN() to PROFILE_END(), as zone "zone"; both must be in the same function, & zone must be a plain name
+//(ex: an enum value), since it is also used to name the local variable holding the start time
+#define PROFILE_BEGIN(Profiler, zone) uint32_t profile_start_##zone = Profiler::begin()
+#define PROFILE_END(Profiler, zone) Profiler::end(zone, profile_start_##zone)
+
+template <uint8_t NUM_ZONES, typename COUNTER = TimerCounter<2,8>, uint8_t NUM_BUCKETS = 16>
+class SectionProfiler
+{
+  static_assert(NUM_BUCKETS >= 2 && NUM_BUCKETS <= 33, "SectionProfiler: NUM_BUCKETS must be 2 to 33");
+
+  public:
+    struct Stats
+    {
+      uint32_t count; //# of times the zone ran
+      uint32_t min; //counts
+      uint32_t max; //counts
+      uint64_t sum; //counts; sum/count = mean
+      uint16_t histogram[NUM_BUCKETS]; //see the top of this file; each bucket saturates at 65535
+    };
+
+    //times one run of a zone, from its construction to its destruction
+    class Scope
+    {
+      public:
+        inline explicit Scope(uint8_t zone) : _zone(zone), _t_start(begin()) {}
+        inline ~Scope() { end(_zone, _t_start); }
+      private:
+        uint8_t _zone;
+        uint32_t _t_start;
+    };
+
+    //measure the cost of get_count() itself (the smallest difference between 2 back-to-back calls), to be subtracted from every
+    //duration; call once, after the timer's setup()
+    static void calibrate()
+    {
+      uint32_t overhead = 0xFFFFFFFF;
+      for (uint8_t i = 0; i < 32; i++)
+      {
+        uint32_t t_start = COUNTER::get_count();
+        uint32_t t_end = COUNTER::get_count();
+        if (t_end - t_start < overhead)
+          overhead = t_end - t_start;
+      }
+      _overhead = overhead > 0xFF ? 0xFF : (uint8_t)overhead;
+    }
+
+    static inline uint8_t get_overhead() { return _overhead; }
+
+    static inline uint32_t begin()
+    {
+      return COUNTER::get_count();
+    }
+
+    static inline void end(uint8_t zone, uint32_t t_start)
+    {
+      uint32_t t_end = COUNTER::get_count();
+      record(zone, t_end - t_start);
+    }
+
+    //add one duration (in counts, before subtracting the overhead) to a zone's statistics
+    static void record(uint8_t zone, uint32_t duration)
+    {
+      if (zone >= NUM_ZONES)
+        return;
+      duration = duration > _overhead ? duration - _overhead : 0;
+      uint8_t bucket = log2_bucket(duration);
+      uint8_t SREG_old = SREG;
+      cli();
+      Stats& stats = _stats[zone];
+      if (stats.count == 0 || duration < stats.min)
+        stats.min = duration;
+      if (duration > stats.max)
+        stats.max = duration;
+      stats.count++;
+      stats.sum += duration;
+      if (stats.histogram[bucket] != 0xFFFF)
+        stats.histogram[bucket]++;
+      SREG = SREG_old;
+    }
+
+    //copy out one zone's statistics
+    static void get_stats(uint8_t zone, Stats& stats)
+    {
+      uint8_t SREG_old = SREG;
+      cli();
+      stats = _stats[zone];
+      SREG = SREG_old;
+    }
+
+    //clear every zone's statistics (but not the calibrated overhead)
+    static void reset()
+    {
+      uint8_t SREG_old = SREG;
+      cli();
+      for (uint8_t zone = 0; zone < NUM_ZONES; zone++)
+      {
+        Stats& stats = _stats[zone];
+        stats.count = 0;
+        stats.min = 0;
+        stats.max = 0;
+        stats.sum = 0;
+        for (uint8_t bucket = 0; bucket < NUM_BUCKETS; bucket++)
+          stats.histogram[bucket] = 0;
+      }
+      SREG = SREG_old;
+    }
+
+    //which histogram bucket a duration falls into; see the top of this file
+    static inline uint8_t log2_bucket(uint32_t duration)
+    {
+      uint8_t bucket = 0;
+      //skip whole bytes first, so the bit loop below runs at most 8 times
+      if (duration >> 16) { bucket = 16; duration >>= 16; }
+      if (duration >> 8) { bucket += 8; duration >>= 8; }
+      while (duration) { bucket++; duration >>= 1; }
+      return bucket < NUM_BUCKETS ? bucket : NUM_BUCKETS - 1;
+    }
+
+    #if defined(ARDUINO)
+    //print every zone's statistics, in us; names (optional) is an array of NUM_ZONES zone names
+    static void dump(Print& out, const char* const* names = 0)
+    {
+      typedef TimerCounterTicks<COUNTER> ticks_t;
+      out.print(F("SectionProfiler: get_count() overhead subtracted = ")); out.print(_overhead); out.println(F(" counts"));
+      for (uint8_t zone = 0; zone < NUM_ZONES; zone++)
+      {
+        Stats stats;
+        get_stats(zone, stats);
+        if (names)
+          out.print(names[zone]);
+        else
+        {
+          out.print(F("zone ")); out.print(zone);
+        }
+        out.print(F(": count = ")); out.print(stats.count);
+        if (stats.count == 0)
+        {
+          out.println();
+          continue;
+        }
+        out.print(F(", min = ")); out.print(ticks_t(stats.min).to_micros().value);
+        out.print(F("us, mean = ")); out.print(ticks_t((uint32_t)(stats.sum/stats.count)).to_micros().value);
+        out.print(F("us, max = ")); out.print(ticks_t(stats.max).to_micros().value);
+        out.println(F("us"));
+        out.print(F("  histogram (counts < 2^b): "));
+        for (uint8_t bucket = 0; bucket < NUM_BUCKETS; bucket++)
+        {
+          out.print(stats.histogram[bucket]);
+          out.print(bucket < NUM_BUCKETS - 1 ? F(" ") : F("\n"));
+        }
+      }
+    }
+    #endif
+
+  private:
+    static Stats _stats[NUM_ZONES];
+    static uint8_t _overhead; //counts
+};
+template <uint8_t NUM_ZONES, typename COUNTER, uint8_t NUM_BUCKETS>
+typename SectionProfiler<NUM_ZONES, COUNTER, NUM_BUCKETS>::Stats SectionProfiler<NUM_ZONES, COUNTER, NUM_BUCKETS>::_stats[NUM_ZONES];
+template <uint8_t NUM_ZONES, typename COUNTER, uint8_t NUM_BUCKETS>
+uint8_t SectionProfiler<NUM_ZONES, COUNTER, NUM_BUCKETS>::_overhead = 0;
+
+#endif
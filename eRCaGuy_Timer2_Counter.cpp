@@ -54,6 +54,11 @@ I heavily reference the 660 pg. Atmega328 datasheet, which can be found here:  h
 VERSION HISTORY:
 (most recent event on top; format year-month-day, ex: 20131211 is Dec. 11, 2013):
 ---------------------------------------------------------------------------------
+20261016 - get_count() is now inline, composes its result from bytes rather than via "_overflow_count*256 + tcnt2_save", no longer 
+          writes it back to a member variable, & keeps interrupts off only while reading; added get_count_in_isr() & get_count64()
+20261016 - the Timer2 code now lives in eRCaGuy_TimerCounter.h as TimerCounter<2,8>, a compile-time template which can also run on 
+          Timer0 or Timer1; this class now simply wraps it.  Also, clearing TIFR2's overflow flag now writes only that bit (TIFR2 = _BV(TOV2)) 
+          rather than doing "TIFR2 |= 0b00000001", which would also have cleared any pending Timer2 compare match flags.
 20140709 - fixed a major problem with my interrupts() call, which was allowing nested interrupts to occur whenever a call to the time 
           (ex: "timer1.get_count()") was done within an already-occurring Interrupt Service Routine; I replaced "interrupts();" with "SREG = SREG_old;"
 20140530 - changed the function (method) names slightly to remove any reference to "T2" in the method names
@@ -82,6 +87,8 @@ get_micros(); //returns the Timer2 microsecond time, with a precision of 0.5us,
                  //the preferred way of getting time.  It is better to get the time by calling "get_T2_count()" then dividing the value by 2.  By choosing whether or not
                  //you want to call "get_T2_count()" or "get_T2_micros()," you can decide if you need the extra precision of a float, or not, at the cost of having 
                  //slightly slower code.
+                 //[20261016: to avoid floats altogether, see eRCaGuy_TimerCounter_Durations.h, ex: Ticks(timer2.get_count()).to_micros(),
+                 //which is just a shift; get_micros() is kept as-is for compatibility]
 reset(); //resets the Timer2 counters back to 0.  Very useful if you want to count up from a specific moment in time, or obtain an "elapsed time."
 revert_to_normal(); //this function might also be called "unsetup_T2".  It simply returns Timer2 to its normal state that Arduino had it in prior to calling "setup_T2"
 unsetup(); //the exact same as "revert_T2_to_normal()"
@@ -90,8 +97,13 @@ overflow_interrupt_off(); //turns off the Timer 2 overflow interrrupt so that yo
                        //to call unsetup_T2() in order to change all of Timer2's settings back to default.
                        //Since an interrupt takes ~5us to execute, and my Timer2 will overflow every 128us, disabling the Timer2 overflow interrupt will prevent 
                        //you from losing that amount of time (~5us) every 128us.
+                       //[20261016: see TIMER_COUNTER_OVF_ISR_CYCLES & TimerCounter::OVF_ISR_LOAD_PPM in eRCaGuy_TimerCounter.h for the numbers at 
+                       //every prescaler, & the choose_prescaler example to measure them.  The overflow ISR is now a 28-cycle (1.75us) assembly 
+                       //ISR by default; see TIMER_COUNTER_FAST_OVF_ISR]
                        //Source: Nick Gammon; "Interrupts" article; "How long does it take to execute an ISR?" section, found here: http://www.gammon.com.au/forum/?id=11488
                        //Note: If you diable the Timer 2 overflow interrupt but still call get_count() or get_micros() at least every 128us, you will notice no difference in the counter, since calling get_count() or get_micros() also checks the interrupt flag and increments the overflow counter automatically.  You have to wait > 128us before you see any missed overflow counts.
+                       //[20261016: for a supported way to do this, which turns the overflow interrupt back on by itself whenever you stop calling 
+                       //get_count() for too long, & reports any overflows lost anyway, see TimerCounterTickless in eRCaGuy_TimerCounter_Tickless.h]
 overflow_interrupt_on(); //turns Timer 2's overflow interrupt back on, so that the overflow counter will start to increment again; see "overflow_interrupt_off()"
                             //explanation for more details.
 					  
@@ -117,87 +129,60 @@ Additional Resources:
 eRCaGuy_Timer2_Counter timer2;
 
 //Interrupt Service Routine (ISR) for when Timer2's counter overflows; this will occur every 128us
-ISR(TIMER2_OVF_vect) //Timer2's counter has overflowed 
-{
-  timer2.increment_overflow_count(); //increment the timer2 overflow counter
-}
+//-this is ISR(TIMER2_OVF_vect); it increments the overflow counter shared by "timer2" and any TimerCounter<2,...> in a sketch
+TIMER_COUNTER_OVF_ISR(2)
 
 //define class constructor method
 eRCaGuy_Timer2_Counter::eRCaGuy_Timer2_Counter()
 {
-  //initialize member variables
-  _overflow_count = 0;
-  _total_count = 0;
+  //nothing to initialize: all state is in TimerCounterState<2>, which is zero-initialized
 }
 
+//NB: the bodies of the methods below now live in eRCaGuy_TimerCounter.h, as TimerCounter<2,8>; they are the same code, written 
+//once for all 3 timers.  See there for the details.
+
 //setup_T2() --Configure Timer2
 //This function MUST be called before any of the other Timer2 functions will work.  This function will generally only be called one time in your setup() loop. "setup_T2()" prepares Timer2 and speeds it up to provide greater precision than micros() can give.
+//-backs up TCCR2A & TCCR2B, sets the prescaler to 8 (datasheet pg 158-159), enables the Timer2 overflow interrupt (datasheet pg. 159-160), and
+// sets Timer2 to "normal" operation mode (WGM22:0 = 0) so that TCNT2 counts only UP (datasheet pg. 147, 155, & 157-158, incl. Table 18-8).
+//-Note: don't forget that when you speed up Timer2 like this you are also affecting any PWM output (using analogWrite) on Pins 3 & 11.  
+// Refer to this link: http://playground.arduino.cc/Main/TimerPWMCheatsheet, as well as to this source here:  http://www.oreilly.de/catalog/arduinockbkger/Arduino_Kochbuch_englKap_18.pdf
 void eRCaGuy_Timer2_Counter::setup()
 {
-  //backup variables
-  _tccr2a_save = TCCR2A; //first, backup some values
-  _tccr2b_save = TCCR2B; //backup some more values
-  
-  //increase the speed of timer2; see below link, as well as the datasheet pg 158-159.
-  TCCR2B = TCCR2B & 0b11111000 | 0x02; //Timer2 is now faster than default; see here for more info: http://playground.arduino.cc/Main/TimerPWMCheatsheet
-  //Note: don't forget that when you speed up Timer2 like this you are also affecting any PWM output (using analogWrite) on Pins 3 & 11.  
-  //Refer to the link just above, as well as to this source here:  http://www.oreilly.de/catalog/arduinockbkger/Arduino_Kochbuch_englKap_18.pdf
-
-  //Enable Timer2 overflow interrupt; see datasheet pg. 159-160
-  TIMSK2 |= 0b00000001; //enable Timer2 overflow interrupt. (by making the right-most bit in TIMSK2 a 1)
-  //TIMSK2 &= 0b11111110; //use this code to DISABLE the Timer2 overflow interrupt, if you ever wish to do so later. (see datasheet pg. 159-160)
-  
-  //set timer2 to "normal" operation mode.  See datasheet pg. 147, 155, & 157-158 (incl. Table 18-8).  
-  //-This is important so that the timer2 counter, TCNT2, counts only UP and not also down.
-  //-To do this we must make WGM22, WGM21, & WGM20, within TCCR2A & TCCR2B, all have values of 0.
-  TCCR2A &= 0b11111100; //set WGM21 & WGM20 to 0 (see datasheet pg. 155).
-  TCCR2B &= 0b11110111; //set WGM22 to 0 (see pg. 158).
+  Counter::setup();
 }  
   
 //get total count for Timer2
-unsigned long eRCaGuy_Timer2_Counter::get_count()
-{
-  uint8_t SREG_old = SREG; //back up the AVR Status Register; see example in datasheet on pg. 14, as well as Nick Gammon's "Interrupts" article - http://www.gammon.com.au/forum/?id=11488
-  noInterrupts(); //prepare for critical section of code
-  uint8_t tcnt2_save = TCNT2; //grab the counter value from Timer2
-  boolean flag_save = bitRead(TIFR2,0); //grab the timer2 overflow flag value; see datasheet pg. 160
-  if (flag_save) { //if the overflow flag is set
-    tcnt2_save = TCNT2; //update variable just saved since the overflow flag could have just tripped between previously saving the TCNT2 value and reading bit 0 of TIFR2.  
-                        //If this is the case, TCNT2 might have just changed from 255 to 0, and so we need to grab the new value of TCNT2 to prevent an error of up 
-                        //to 127.5us in any time obtained using the T2 counter (ex: T2_micros). (Note: 255 counts / 2 counts/us = 127.5us)
-                        //Note: this line of code DID in fact fix the error just described, in which I periodically saw an error of ~127.5us in some values read in
-                        //by some PWM read code I wrote.
-    _overflow_count++; //force the overflow count to increment
-    TIFR2 |= 0b00000001; //reset Timer2 overflow flag since we just manually incremented above; see datasheet pg. 160; this prevents execution of Timer2's overflow ISR
-  }
-  _total_count = _overflow_count*256 + tcnt2_save; //get total Timer2 count
-  //interrupts(); //allow interrupts again; [updated 20140709] <--WARNING, DO ****NOT**** USE THIS METHOD AFTERALL, OR ELSE IT WILL RE-ENABLE GLOBAL INTERRUPTS IF YOU CALL THIS FUNCTION
-                  //DURING AN INTERRUPT SERVICE ROUTINE, THEREBY CAUSING NESTED INTERRUPTS, WHICH CAN REALLY SCREW THINGS UP.
-  SREG = SREG_old; //use this method instead, to re-enable interrupts if they were enabled before, or to leave them disabled if they were disabled before
-  return _total_count;
-}
+//-NB: get_count(), get_count_in_isr(), & get_count64() are defined inline in the .h file, so that calling them from an ISR 
+// costs no function call (& so that the calling ISR doesn't have to save & restore all of the call-clobbered registers).
+//-with interrupts off (saving & restoring SREG, rather than calling interrupts(), so that calling this from within an ISR does NOT
+// cause nested interrupts [updated 20140709]), grab TCNT2, then check the Timer2 overflow flag (datasheet pg. 160). If the flag is set,
+// TCNT2 is re-read, since it could have just rolled over from 255 to 0 between the two reads; that re-read DID in fact fix an error of 
+// up to 127.5us (255 counts / 2 counts/us) which I periodically saw in some PWM read code I wrote.  The overflow count is then 
+// incremented manually & the flag cleared, so the overflow ISR won't also count it.
+//-the result is composed byte-wise from TCNT2 & the overflow count (TCNT2 is simply the low byte), rather than via a 32-bit 
+// multiply, & it is no longer stored back into a member variable.
+//get_count_in_isr(); //same as get_count(), but skips the SREG save/clear/restore; use it ONLY where interrupts are already off, 
+                      //ex: as the first thing inside an ISR
+//get_count64(); //same as get_count(), but returns a 64-bit (unsigned long long) count which won't roll over after 35.79 minutes 
+                 //like the 32-bit count does; it takes > 1000 years to roll over instead
 
 //get the time in microseconds, as determined by Timer2; the precision will be 0.5 microseconds instead of the 4 microsecond precision of micros()
 float eRCaGuy_Timer2_Counter::get_micros()
 {
-  return get_count()/2.0; 
+  return Counter::get_micros(); 
 }
 
 //reset Timer2's counters
 void eRCaGuy_Timer2_Counter::reset()
 {
-  _overflow_count = 0; //reset overflow counter
-  _total_count = 0; //reset total counter
-  TCNT2 = 0; //reset Timer2 counter
-  TIFR2 |= 0b00000001; //reset Timer2 overflow flag; see datasheet pg. 160; this prevents an immediate execution of Timer2's overflow ISR
+  Counter::reset();
 }
 
 //undo configuration changes for Timer2
 void eRCaGuy_Timer2_Counter::revert_to_normal()
 {
-  overflow_interrupt_off(); //turn off Timer2 overflow interrupts
-  TCCR2A = _tccr2a_save; //restore default settings
-  TCCR2B = _tccr2b_save; //restore default settings
+  Counter::revert_to_normal();
 }
 
 //same as revert_T2_to_normal()
@@ -206,26 +191,20 @@ void eRCaGuy_Timer2_Counter::unsetup()
   revert_to_normal();
 }
 
-//Turn off the Timer2 Overflow Interrupt
+//Turn off the Timer2 Overflow Interrupt; see datasheet pg. 159-160
 void eRCaGuy_Timer2_Counter::overflow_interrupt_off()
 {
-//  TIMSK2 &= 0b11111110; //use this code to DISABLE the Timer2 overflow interrupt; see datasheet pg. 159-160
-  TIMSK2 &= ~(_BV(TOIE2)); //alternate code to do the above; see here for use of _BV: http://194.81.104.27/~brian/microprocessor/BVMacro.pdf 
+  Counter::overflow_interrupt_off();
 }
 
-//Turn the Timer2 Overflow Interrupt Back On
+//Turn the Timer2 Overflow Interrupt Back On; see datasheet pg. 159-160
 void eRCaGuy_Timer2_Counter::overflow_interrupt_on()
 {
-//  TIMSK2 |= 0b00000001; //enable Timer2 overflow interrupt. (by making the right-most bit in TIMSK2 a 1); see datasheet pg. 159-160
-  TIMSK2 |= _BV(TOIE2); //alternate code to do the above; see here for use of _BV: http://194.81.104.27/~brian/microprocessor/BVMacro.pdf 
+  Counter::overflow_interrupt_on();
 }
 
 //Increment overflow counter
 void eRCaGuy_Timer2_Counter::increment_overflow_count()
 {
-  _overflow_count++;
+  Counter::increment_overflow_count();
 }
-  
-  
-
-
@@ -56,6 +56,8 @@ GS: *************NOTE TO SELF************: I referred to the TimerOne Library (h
  #include <WProgram.h>
 #endif
 
+#include "eRCaGuy_TimerCounter.h" //the templated counter this class is now built on; see that file to use Timer0 or Timer1 instead
+
 class eRCaGuy_Timer2_Counter
 {
   public:
@@ -66,7 +68,9 @@ class eRCaGuy_Timer2_Counter
 	//FOR A FULL DESCRIPTION OF WHAT EACH METHOD BELOW DOES, REFER TO THE .CPP FILE.
 	
 	void setup(); 
-	unsigned long get_count();
+	inline unsigned long get_count(); //defined inline (below), since it is the hot path, & is often called from within ISRs
+	inline unsigned long get_count_in_isr();
+	inline unsigned long long get_count64();
 	float get_micros();
 	void reset();
 	void revert_to_normal();
@@ -81,19 +85,31 @@ class eRCaGuy_Timer2_Counter
   private:
 	//declare private class methods (member functions)
 	//N/A
-    //Declare private variables (ie: "member variables," or variables which are members of and accessible by this class only):
-	//volatile (used in ISRs)
-	volatile unsigned long _overflow_count; //Timer2 overflow counter; updated in ISR, so must be declared volatile (see here: http://arduino.cc/en/Reference/Volatile)
-	  //GS: for more info on static class members, see here: http://www.tutorialspoint.com/cplusplus/cpp_static_members.htm (or PDF pg. 148-149)
-	unsigned long _total_count; //Timer2 total counter
-	byte _tccr2a_save; //will be used to backup default settings
-	byte _tccr2b_save; //will be used to backup default settings
+	//The overflow counter & the saved register settings now live in TimerCounterState<2> (see eRCaGuy_TimerCounter.h), shared with 
+	//any TimerCounter<2,...> in the sketch, since there is only one Timer2 & one Timer2 overflow ISR.
+	typedef TimerCounter<2,8> Counter; //Timer2, prescaler 8 --> 0.5us per count @ 16MHz
 };
 
 //Declare the external existence (defined in the .cpp file) of object timer2, so that you can access it in your Arduino sketch simply by including this library, via its header file (ex: #include <eRCaGuy_Timer2_Counter.h>)
 //This is absolutely necessary or else the Arduino sketch that includes this library will not compile.
 //For more info on "extern" see here: http://www.geeksforgeeks.org/understanding-extern-keyword-in-c/
 extern eRCaGuy_Timer2_Counter timer2;
+
+//inline method definitions; see the .cpp file for their descriptions
+inline unsigned long eRCaGuy_Timer2_Counter::get_count()
+{
+  return Counter::get_count();
+}
+
+inline unsigned long eRCaGuy_Timer2_Counter::get_count_in_isr()
+{
+  return Counter::get_count_in_isr();
+}
+
+inline unsigned long long eRCaGuy_Timer2_Counter::get_count64()
+{
+  return Counter::get_count64();
+}
 #endif
 
 
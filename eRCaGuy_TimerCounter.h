@@ -0,0 +1,608 @@
+/*
+eRCaGuy_TimerCounter
+-the same 0.5us-precision "micros()" replacement as eRCaGuy_Timer2_Counter, but able to run on Timer0, Timer1, OR Timer2, with
+ the timer and prescaler chosen at compile time, ex: TimerCounter<1,8>
+-every method is a static inline function which, once the template is specialized, compiles down to direct register accesses
+ (lds/sts/in/out on the AVR), with no pointers to registers, no switch on the timer number, and no function call in the hot path.
+ In other words, TimerCounter<2,8>::get_count() costs exactly what a hand-written Timer2-only version would cost.
+
+Basic usage (in your sketch):
+  #include <eRCaGuy_TimerCounter.h>
+  TimerCounter<1,8> timer1; //a Timer1-based counter, with 0.5us per count @ 16MHz; note: this object has no data--it's just a handle
+  TIMER_COUNTER_OVF_ISR(1); //creates ISR(TIMER1_OVF_vect) for the Timer1 overflow counter; put this at global scope, once
+
+  void setup() { timer1.setup(); }
+  void loop() { unsigned long t = timer1.get_count(); ... }
+
+Which timer to choose:
+-Timer2 (8-bit): the original eRCaGuy_Timer2_Counter timer.  Interferes with tone() and with PWM on pins 3 & 11.  Its overflow
+ ISR is ALREADY defined by this library (in eRCaGuy_Timer2_Counter.cpp, for the "timer2" object), so do NOT use
+ TIMER_COUNTER_OVF_ISR(2) in an Arduino sketch.
+-Timer1 (16-bit): overflows 256x less often than Timer2, so the overflow ISR costs 256x less CPU, but the Servo library needs it.
+ Interferes with PWM on pins 9 & 10.
+-Timer0 (8-bit): the Arduino core already uses Timer0 (with its own TIMER0_OVF_vect ISR) for millis(), micros(), & delay(), so
+ TimerCounter<0,...> is only usable in non-Arduino (plain avr-gcc) builds where that core ISR doesn't exist.  It is included
+ for completeness.
+
+Available prescalers (see the "Clock Select Bit Description" tables in the datasheet):
+-Timer0 & Timer1: 1, 8, 64, 256, 1024
+-Timer2: 1, 8, 32, 64, 128, 256, 1024
+Choosing an unavailable prescaler is a compile-time error.
+
+Choosing a prescaler: resolution vs. overflow ISR load
+-the smaller the prescaler, the finer the resolution, but the more often the timer overflows, & every overflow costs one ISR of
+ ~28 cycles with the default assembly ISR, or up to ~68 cycles with the C++ one (TIMER_COUNTER_OVF_ISR_CYCLES; see
+ TIMER_COUNTER_FAST_OVF_ISR).  NB: neither cycle count is measured: the 28 is counted by hand from the AVR Instruction Set
+ Manual, & the 68 is an unverified guess, meant as an upper bound, so the CPU load columns below (& OVF_ISR_LOAD_PPM) are
+ estimates too, & the C++ column a rough one; to measure them on your board, run the benchmark_cycles & choose_prescaler examples.
+ For Timer2 @ 16MHz:
+   prescaler | resolution | overflow every | ISR calls/sec | est. CPU load, assembly ISR | C++ ISR (guess)
+   1         | 0.0625us   | 16us           | 62500         | 10.9%                       | 26.6%
+   8         | 0.5us      | 128us          | 7812.5        | 1.37%                       | 3.32%   <--the "timer2" object
+   32        | 2us        | 512us          | 1953.1        | 0.34%                       | 0.83%
+   64        | 4us        | 1024us         | 976.6         | 0.17%                       | 0.42%
+   128       | 8us        | 2048us         | 488.3         | 0.085%                      | 0.21%
+   256       | 16us       | 4096us         | 244.1         | 0.043%                      | 0.10%
+   1024      | 64us       | 16384us        | 61.0          | 0.011%                      | 0.026%
+ Timer1 is 16-bit, so it overflows 256x less often: ex: prescaler 8 gives 0.5us resolution for only 0.0053% (assembly ISR) or
+ 0.013% (C++ ISR) CPU load.
+-these numbers are available as compile-time constants (COUNT_PERIOD_PS, OVERFLOW_PERIOD_US, OVF_ISR_LOAD_PPM, etc.), & 
+ print_config() prints them; see the choose_prescaler example.
+-the "timer2" object always uses prescaler 8; to use Timer2 with another prescaler, use ex: TimerCounter<2,1> directly.  It shares
+ the library's Timer2 overflow ISR, so just call its setup() instead of timer2.setup().
+
+Host (PC) builds:
+-when __AVR__ is not defined, the registers come from eRCaGuy_TimerCounter_mock.h instead of <avr/io.h>, so this exact code can
+ be unit-tested with g++ on Linux.  See that file.
+
+The methods below have the same names & meanings as those of eRCaGuy_Timer2_Counter; FOR A FULL DESCRIPTION OF EACH ONE, REFER
+TO eRCaGuy_Timer2_Counter.cpp.
+
+I heavily reference the 660 pg. Atmega328 datasheet, which can be found here:  http://www.atmel.com/Images/Atmel-8271-8-bit-AVR-Microcontroller-ATmega48A-48PA-88A-88PA-168A-168PA-328-328P_datasheet.pdf
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#ifndef eRCaGuy_TimerCounter_h
+#define eRCaGuy_TimerCounter_h
+
+#if defined(__AVR__)
+ #if defined(ARDUINO) && ARDUINO >= 100
+  #include <Arduino.h>
+ #elif defined(ARDUINO)
+  #include <WProgram.h>
+ #else
+  #include <avr/io.h>
+  #include <avr/interrupt.h>
+ #endif
+ typedef volatile uint8_t TimerCounterReg8;
+ typedef volatile uint16_t TimerCounterReg16;
+ typedef volatile uint32_t TimerCounterShared32; //variables shared with the overflow ISR
+ typedef volatile uint16_t TimerCounterShared16;
+#else
+ #include "eRCaGuy_TimerCounter_mock.h"
+ typedef TimerCounterMockReg<uint8_t> TimerCounterReg8;
+ typedef TimerCounterMockReg<uint16_t> TimerCounterReg16;
+ typedef TimerCounterMockShared<uint32_t> TimerCounterShared32;
+ typedef TimerCounterMockShared<uint16_t> TimerCounterShared16;
+#endif
+
+#include <stdint.h>
+
+//Which overflow ISR TIMER_COUNTER_OVF_ISR() defines (see the bottom of this file):
+//-1: a hand-written assembly ISR (ISR_NAKED) which saves only r24 & SREG, & increments the overflow count 1 byte at a time, 
+// stopping at the first byte which doesn't roll over to 0.  The default on the AVR.
+//-0: the plain C++ ISR, which calls increment_overflow_count(); the compiler saves & restores ~10 registers around it.  Always 
+// used in host (PC) builds.
+//-to choose, #define it before including this file.  NB: the Arduino IDE compiles the library's .cpp file, which holds the Timer2 
+// overflow ISR, separately from your sketch, so for Timer2 change the default here, or pass -DTIMER_COUNTER_FAST_OVF_ISR=0 to
+// the compiler.
+#ifndef TIMER_COUNTER_FAST_OVF_ISR
+ #if defined(__AVR__)
+  #define TIMER_COUNTER_FAST_OVF_ISR 1
+ #else
+  #define TIMER_COUNTER_FAST_OVF_ISR 0
+ #endif
+#endif
+#if TIMER_COUNTER_FAST_OVF_ISR && !defined(__AVR__)
+ #error "eRCaGuy_TimerCounter: TIMER_COUNTER_FAST_OVF_ISR 1 (the assembly overflow ISR) is for the AVR only"
+#endif
+
+//ESTIMATED CPU cycles per overflow interrupt, from the interrupt being taken to "reti" returning, including the 4-cycle interrupt 
+//response, the "jmp" in the vector table, & the ISR's register saves & restores; see TimerCounter::OVF_ISR_LOAD_PPM.  Neither 
+//value has been measured, in a cycle-accurate simulator or on a board:
+//-assembly ISR: 28 cycles (1.75us @ 16MHz), counted by hand from the AVR Instruction Set Manual's cycle counts: 4 (interrupt
+// response) + 3 (jmp) + 5 (save r24 & SREG) + 7 (lds, inc, sts, brne of the low byte) + 5 (restore SREG & r24) + 4 (reti).
+// That's 255 times out of 256; each further byte the carry reaches adds 6.
+// extras/ovf_isr_asm_test re-adds this from the ISR's instructions (& checks its carry chain), but it's still the same hand count.
+//-C++ ISR: 68 cycles (4.25us @ 16MHz) is an UNVERIFIED GUESS, meant as an upper bound; it is not counted from any compiler
+// output.  The ISR calls the inlined increment_overflow_count(), & its real cost depends on how many registers the compiler
+// saves & restores around that, which no avr-objdump listing or simulator run here has checked.  For scale only: Nick Gammon
+// measured "~5us per ISR" for simple C++ ISRs (http://www.gammon.com.au/forum/?id=11488).
+//-to measure it on your board, see the benchmark_cycles example
+//-you may #define your own value before including this file
+#ifndef TIMER_COUNTER_OVF_ISR_CYCLES
+ #if TIMER_COUNTER_FAST_OVF_ISR
+  #define TIMER_COUNTER_OVF_ISR_CYCLES 28
+ #else
+  #define TIMER_COUNTER_OVF_ISR_CYCLES 68
+ #endif
+#endif
+
+//---------------------------------------------------------------------------------------------------
+//Register "traits": one specialization per hardware timer.  Each accessor returns a reference to the register itself, so once
+//inlined it is the same as writing TCNT2 (etc.) directly.
+//---------------------------------------------------------------------------------------------------
+template <uint8_t TIMER_ID> struct TimerCounterRegs; //not defined on purpose: only Timer0, Timer1, & Timer2 are supported
+
+template <>
+struct TimerCounterRegs<0>
+{
+  typedef uint8_t count_t; //TCNT0 width
+  typedef TimerCounterReg8 tcnt_reg_t;
+  static const uint8_t COUNTER_BITS = 8;
+  static const uint8_t TOV_BIT = TOV0;
+  static const uint8_t TOIE_BIT = TOIE0;
+  static const uint8_t WGM_A_MASK = _BV(WGM01) | _BV(WGM00); //WGM bits in TCCR0A; see datasheet pg. 104-107
+  static const uint8_t WGM_B_MASK = _BV(WGM02); //WGM bits in TCCR0B
+  static const uint8_t CS_MASK = _BV(CS02) | _BV(CS01) | _BV(CS00);
+  static inline TimerCounterReg8& tccra() { return TCCR0A; }
+  static inline TimerCounterReg8& tccrb() { return TCCR0B; }
+  static inline tcnt_reg_t& tcnt() { return TCNT0; }
+  static inline TimerCounterReg8& tifr() { return TIFR0; }
+  static inline TimerCounterReg8& timsk() { return TIMSK0; }
+  static const uint8_t OCIEA_BIT = OCIE0A;
+  static const uint8_t OCIEB_BIT = OCIE0B;
+  static const uint8_t OCFA_BIT = OCF0A;
+  static const uint8_t OCFB_BIT = OCF0B;
+  static inline tcnt_reg_t& ocra() { return OCR0A; } //same width as TCNT0
+  static inline tcnt_reg_t& ocrb() { return OCR0B; }
+  //Clock Select bits for a given prescaler, or 0 if not available; datasheet pg. 110, Table 15-9
+  static constexpr uint8_t clock_select(uint16_t prescaler)
+  {
+    return prescaler == 1 ? 1 : prescaler == 8 ? 2 : prescaler == 64 ? 3 : prescaler == 256 ? 4 : prescaler == 1024 ? 5 : 0;
+  }
+};
+
+template <>
+struct TimerCounterRegs<1>
+{
+  typedef uint16_t count_t; //TCNT1 width
+  typedef TimerCounterReg16 tcnt_reg_t;
+  static const uint8_t COUNTER_BITS = 16;
+  static const uint8_t TOV_BIT = TOV1;
+  static const uint8_t TOIE_BIT = TOIE1;
+  static const uint8_t WGM_A_MASK = _BV(WGM11) | _BV(WGM10); //WGM bits in TCCR1A; see datasheet pg. 132-135
+  static const uint8_t WGM_B_MASK = _BV(WGM13) | _BV(WGM12); //WGM bits in TCCR1B
+  static const uint8_t CS_MASK = _BV(CS12) | _BV(CS11) | _BV(CS10);
+  static inline TimerCounterReg8& tccra() { return TCCR1A; }
+  static inline TimerCounterReg8& tccrb() { return TCCR1B; }
+  static inline tcnt_reg_t& tcnt() { return TCNT1; } //16-bit read via the TEMP register; only safe with interrupts off, as done below
+  static inline TimerCounterReg8& tifr() { return TIFR1; }
+  static inline TimerCounterReg8& timsk() { return TIMSK1; }
+  static const uint8_t OCIEA_BIT = OCIE1A;
+  static const uint8_t OCIEB_BIT = OCIE1B;
+  static const uint8_t OCFA_BIT = OCF1A;
+  static const uint8_t OCFB_BIT = OCF1B;
+  static inline tcnt_reg_t& ocra() { return OCR1A; } //same width as TCNT1
+  static inline tcnt_reg_t& ocrb() { return OCR1B; }
+  //Clock Select bits for a given prescaler, or 0 if not available; datasheet pg. 137, Table 16-5
+  static constexpr uint8_t clock_select(uint16_t prescaler)
+  {
+    return prescaler == 1 ? 1 : prescaler == 8 ? 2 : prescaler == 64 ? 3 : prescaler == 256 ? 4 : prescaler == 1024 ? 5 : 0;
+  }
+};
+
+template <>
+struct TimerCounterRegs<2>
+{
+  typedef uint8_t count_t; //TCNT2 width
+  typedef TimerCounterReg8 tcnt_reg_t;
+  static const uint8_t COUNTER_BITS = 8;
+  static const uint8_t TOV_BIT = TOV2;
+  static const uint8_t TOIE_BIT = TOIE2;
+  static const uint8_t WGM_A_MASK = _BV(WGM21) | _BV(WGM20); //WGM bits in TCCR2A; see datasheet pg. 155
+  static const uint8_t WGM_B_MASK = _BV(WGM22); //WGM bits in TCCR2B; see datasheet pg. 158
+  static const uint8_t CS_MASK = _BV(CS22) | _BV(CS21) | _BV(CS20);
+  static inline TimerCounterReg8& tccra() { return TCCR2A; }
+  static inline TimerCounterReg8& tccrb() { return TCCR2B; }
+  static inline tcnt_reg_t& tcnt() { return TCNT2; }
+  static inline TimerCounterReg8& tifr() { return TIFR2; }
+  static inline TimerCounterReg8& timsk() { return TIMSK2; }
+  static const uint8_t OCIEA_BIT = OCIE2A;
+  static const uint8_t OCIEB_BIT = OCIE2B;
+  static const uint8_t OCFA_BIT = OCF2A;
+  static const uint8_t OCFB_BIT = OCF2B;
+  static inline tcnt_reg_t& ocra() { return OCR2A; } //same width as TCNT2
+  static inline tcnt_reg_t& ocrb() { return OCR2B; }
+  //Clock Select bits for a given prescaler, or 0 if not available; datasheet pg. 158-159, Table 18-9
+  static constexpr uint8_t clock_select(uint16_t prescaler)
+  {
+    return prescaler == 1 ? 1 : prescaler == 8 ? 2 : prescaler == 32 ? 3 : prescaler == 64 ? 4 :
+           prescaler == 128 ? 5 : prescaler == 256 ? 6 : prescaler == 1024 ? 7 : 0;
+  }
+};
+
+//---------------------------------------------------------------------------------------------------
+//Output compare channels A & B, one type per channel, so code can be written once for either, ex: TimerCounterCompare<2,
+//TIMER_COUNTER_CHANNEL_B>::ocr() is OCR2B.  In normal mode, the compare match flag (OCFnx) is set on the timer clock AFTER
+//TCNTn == OCRnx, ie: as TCNTn counts from OCRnx to OCRnx + 1; see the "Timer/Counter Timing Diagrams" in the datasheet
+//(ex: pg. 153).  These are used by eRCaGuy_TimerScheduler.h.
+//---------------------------------------------------------------------------------------------------
+#define TIMER_COUNTER_CHANNEL_A 0
+#define TIMER_COUNTER_CHANNEL_B 1
+
+//the compare match interrupt vector of a channel, ex: ISR(TIMER_COUNTER_COMPARE_VECT(2, B)) is ISR(TIMER2_COMPB_vect)
+#define TIMER_COUNTER_COMPARE_VECT(TIMER_ID, CHANNEL_LETTER) TIMER##TIMER_ID##_COMP##CHANNEL_LETTER##_vect
+
+template <uint8_t TIMER_ID, uint8_t OCIE, uint8_t OCF>
+struct TimerCounterCompareBits
+{
+  typedef TimerCounterRegs<TIMER_ID> Regs;
+  static const uint8_t OCIE_BIT = OCIE;
+  static const uint8_t OCF_BIT = OCF;
+  static inline void interrupt_on() { Regs::timsk() |= _BV(OCIE); }
+  static inline void interrupt_off() { Regs::timsk() &= (uint8_t)~_BV(OCIE); }
+  static inline bool interrupt_is_on() { return Regs::timsk() & _BV(OCIE); }
+  static inline bool flag_is_set() { return Regs::tifr() & _BV(OCF); }
+  static inline void clear_flag() { Regs::tifr() = _BV(OCF); } //writing a 1 clears ONLY this flag
+};
+
+template <uint8_t TIMER_ID, uint8_t CHANNEL> struct TimerCounterCompare;
+
+template <uint8_t TIMER_ID>
+struct TimerCounterCompare<TIMER_ID, TIMER_COUNTER_CHANNEL_A> :
+  TimerCounterCompareBits<TIMER_ID, TimerCounterRegs<TIMER_ID>::OCIEA_BIT, TimerCounterRegs<TIMER_ID>::OCFA_BIT>
+{
+  static inline typename TimerCounterRegs<TIMER_ID>::tcnt_reg_t& ocr() { return TimerCounterRegs<TIMER_ID>::ocra(); }
+};
+
+template <uint8_t TIMER_ID>
+struct TimerCounterCompare<TIMER_ID, TIMER_COUNTER_CHANNEL_B> :
+  TimerCounterCompareBits<TIMER_ID, TimerCounterRegs<TIMER_ID>::OCIEB_BIT, TimerCounterRegs<TIMER_ID>::OCFB_BIT>
+{
+  static inline typename TimerCounterRegs<TIMER_ID>::tcnt_reg_t& ocr() { return TimerCounterRegs<TIMER_ID>::ocrb(); }
+};
+
+//---------------------------------------------------------------------------------------------------
+//Per-timer state.  It is keyed on the timer only (not the prescaler), since there is only one of each hardware timer, and so
+//that one overflow ISR serves any TimerCounter<TIMER_ID,...> specialization.
+//---------------------------------------------------------------------------------------------------
+template <uint8_t TIMER_ID>
+struct TimerCounterState
+{
+  static TimerCounterShared32 overflow_count; //updated in the overflow ISR, so must be volatile
+  static TimerCounterShared16 overflow_count_hi; //carries out of overflow_count, for get_count64(); incremented once every 2^32 overflows
+  static uint8_t tccra_save; //will be used to backup default settings
+  static uint8_t tccrb_save; //will be used to backup default settings
+};
+template <uint8_t TIMER_ID> TimerCounterShared32 TimerCounterState<TIMER_ID>::overflow_count = 0;
+template <uint8_t TIMER_ID> TimerCounterShared16 TimerCounterState<TIMER_ID>::overflow_count_hi = 0;
+template <uint8_t TIMER_ID> uint8_t TimerCounterState<TIMER_ID>::tccra_save = 0;
+template <uint8_t TIMER_ID> uint8_t TimerCounterState<TIMER_ID>::tccrb_save = 0;
+
+//---------------------------------------------------------------------------------------------------
+//Byte composition of the total count.  Rather than computing overflow_count*256 + TCNT (a 32-bit shift/multiply & add), the 
+//bytes of the result are simply picked up from where they already are: TCNT is the low byte(s), & the overflow count is the 
+//rest.  On the AVR this is just register moves.  This relies on little-endian byte order, which both the AVR & x86 hosts use.
+//---------------------------------------------------------------------------------------------------
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+ #error "eRCaGuy_TimerCounter: the byte composition in get_count() requires a little-endian target"
+#endif
+
+union TimerCounterBytes32 { uint32_t u32; uint8_t u8[4]; };
+union TimerCounterBytes64 { uint64_t u64; uint8_t u8[8]; };
+
+template <uint8_t COUNTER_BITS> struct TimerCounterCompose;
+
+template <>
+struct TimerCounterCompose<8>
+{
+  static inline uint32_t count32(uint32_t overflow_count, uint8_t tcnt)
+  {
+    TimerCounterBytes32 ovf, total;
+    ovf.u32 = overflow_count;
+    total.u8[0] = tcnt;
+    total.u8[1] = ovf.u8[0];
+    total.u8[2] = ovf.u8[1];
+    total.u8[3] = ovf.u8[2];
+    return total.u32;
+  }
+  static inline uint64_t count64(uint16_t overflow_count_hi, uint32_t overflow_count, uint8_t tcnt)
+  {
+    TimerCounterBytes32 ovf;
+    TimerCounterBytes64 total;
+    ovf.u32 = overflow_count;
+    total.u8[0] = tcnt;
+    total.u8[1] = ovf.u8[0];
+    total.u8[2] = ovf.u8[1];
+    total.u8[3] = ovf.u8[2];
+    total.u8[4] = ovf.u8[3];
+    total.u8[5] = (uint8_t)overflow_count_hi;
+    total.u8[6] = (uint8_t)(overflow_count_hi >> 8);
+    total.u8[7] = 0;
+    return total.u64;
+  }
+};
+
+template <>
+struct TimerCounterCompose<16>
+{
+  static inline uint32_t count32(uint32_t overflow_count, uint16_t tcnt)
+  {
+    TimerCounterBytes32 ovf, total;
+    ovf.u32 = overflow_count;
+    total.u8[0] = (uint8_t)tcnt;
+    total.u8[1] = (uint8_t)(tcnt >> 8);
+    total.u8[2] = ovf.u8[0];
+    total.u8[3] = ovf.u8[1];
+    return total.u32;
+  }
+  static inline uint64_t count64(uint16_t overflow_count_hi, uint32_t overflow_count, uint16_t tcnt)
+  {
+    TimerCounterBytes32 ovf;
+    TimerCounterBytes64 total;
+    ovf.u32 = overflow_count;
+    total.u8[0] = (uint8_t)tcnt;
+    total.u8[1] = (uint8_t)(tcnt >> 8);
+    total.u8[2] = ovf.u8[0];
+    total.u8[3] = ovf.u8[1];
+    total.u8[4] = ovf.u8[2];
+    total.u8[5] = ovf.u8[3];
+    total.u8[6] = (uint8_t)overflow_count_hi;
+    total.u8[7] = (uint8_t)(overflow_count_hi >> 8);
+    return total.u64;
+  }
+};
+
+//---------------------------------------------------------------------------------------------------
+//The counter itself
+//---------------------------------------------------------------------------------------------------
+template <uint8_t TIMER_ID, uint16_t PRESCALER = 8>
+class TimerCounter
+{
+  private:
+    typedef TimerCounterRegs<TIMER_ID> Regs;
+    typedef TimerCounterState<TIMER_ID> State;
+    typedef typename Regs::count_t count_t;
+    static_assert(Regs::clock_select(PRESCALER) != 0,
+                  "TimerCounter: this prescaler is not available on this timer; see the Clock Select table in the datasheet");
+
+  public:
+    //-----------------------------------------------------------------------------------------------
+    //Resolution vs. overflow ISR load, all derived at compile time from F_CPU, PRESCALER, & the timer's width.  The values in 
+    //the comments are for Timer2 (8-bit) @ 16MHz, prescaler 8 (the "timer2" object) --> prescaler 1.
+    //-----------------------------------------------------------------------------------------------
+    static const uint8_t TIMER_ID_VALUE = TIMER_ID;
+    static const uint16_t PRESCALER_VALUE = PRESCALER;
+    static const uint32_t COUNTS_PER_SECOND = F_CPU/PRESCALER; //2000000 --> 16000000
+    static const uint32_t COUNT_PERIOD_PS = (uint32_t)(1000000000000ULL*PRESCALER/F_CPU); //resolution, in picoseconds; 500000 --> 62500
+    static const uint32_t COUNTS_PER_OVERFLOW = 1UL << Regs::COUNTER_BITS; //256
+    static const uint32_t OVERFLOW_PERIOD_US = (uint32_t)((1000000ULL*PRESCALER*COUNTS_PER_OVERFLOW + F_CPU/2)/F_CPU); //128 --> 16
+    static const uint32_t OVERFLOW_RATE_MILLIHZ = (uint32_t)(1000ULL*COUNTS_PER_SECOND/COUNTS_PER_OVERFLOW); //overflow ISR calls per 1000 sec; 7812500 --> 62500000
+    static const uint32_t ROLLOVER_SECONDS = (uint32_t)((1ULL << 32)/COUNTS_PER_SECOND); //when get_count() rolls over; 2147 (35.79 min) --> 268
+    //estimated fraction of the CPU spent in the overflow ISR, in parts per million: cycles per ISR / cycles between ISRs; only as
+    //good as TIMER_COUNTER_OVF_ISR_CYCLES (a hand count for the assembly ISR, an unverified upper-bound guess for the C++ one);
+    //13671 (1.37%) --> 109375 (10.9%) with the assembly ISR, or 33203 (3.3%) --> 265625 (26.6%) with the C++ one
+    static const uint32_t OVF_ISR_LOAD_PPM = (uint32_t)(1000000ULL*TIMER_COUNTER_OVF_ISR_CYCLES/((uint32_t)PRESCALER*COUNTS_PER_OVERFLOW));
+
+    //configure the timer: save its old settings, set the prescaler, set "normal" (count up only) mode, & enable the overflow ISR
+    static inline void setup()
+    {
+      State::tccra_save = Regs::tccra();
+      State::tccrb_save = Regs::tccrb();
+      Regs::tccrb() = (Regs::tccrb() & ~Regs::CS_MASK) | Regs::clock_select(PRESCALER);
+      Regs::timsk() |= _BV(Regs::TOIE_BIT);
+      Regs::tccra() &= (uint8_t)~Regs::WGM_A_MASK;
+      Regs::tccrb() &= (uint8_t)~Regs::WGM_B_MASK;
+    }
+
+    //get the total count, in units of PRESCALER/F_CPU seconds (0.5us for a prescaler of 8 @ 16MHz); wraps every 2^32 counts
+    //(35.79 minutes @ 0.5us/count); use get_count64() if that's not long enough.
+    //-only the register & overflow-count reads are done with interrupts off; the result is composed afterwards, from locals, & 
+    // nothing is written back to RAM except in the rare case that an overflow is pending.
+    static inline uint32_t get_count()
+    {
+      uint8_t SREG_old = SREG; //back up the AVR Status Register, rather than blindly re-enabling interrupts at the end; see the .cpp file
+      cli();
+      count_t tcnt_save;
+      uint32_t overflow_count;
+      read_counts(tcnt_save, overflow_count);
+      SREG = SREG_old;
+      return TimerCounterCompose<Regs::COUNTER_BITS>::count32(overflow_count, tcnt_save);
+    }
+
+    //same as get_count(), but for use ONLY where interrupts are already off, ex: at the top of an ISR (without ISR_NOBLOCK).  It 
+    //skips saving, clearing, & restoring SREG.
+    static inline uint32_t get_count_in_isr()
+    {
+      count_t tcnt_save;
+      uint32_t overflow_count;
+      read_counts(tcnt_save, overflow_count);
+      return TimerCounterCompose<Regs::COUNTER_BITS>::count32(overflow_count, tcnt_save);
+    }
+
+    //get the extended total count; same units as get_count(), but it won't wrap for 2^56 counts (> 1000 years @ 0.5us/count) on
+    //Timer0/2, or 2^64 counts on Timer1
+    static inline uint64_t get_count64()
+    {
+      uint8_t SREG_old = SREG;
+      cli();
+      count_t tcnt_save;
+      uint32_t overflow_count;
+      read_counts(tcnt_save, overflow_count);
+      uint16_t overflow_count_hi = State::overflow_count_hi; //read after read_counts(), so it includes any carry it just did
+      SREG = SREG_old;
+      return TimerCounterCompose<Regs::COUNTER_BITS>::count64(overflow_count_hi, overflow_count, tcnt_save);
+    }
+
+    //get the time in microseconds, as a float
+    static inline float get_micros()
+    {
+      return get_count()*(PRESCALER*1000000.0/F_CPU);
+    }
+
+    #if defined(ARDUINO)
+    //print the resolution vs. overflow ISR load numbers above, ex: TimerCounter<2,1>::print_config(Serial);
+    //Use it to pick the largest prescaler that still gives the resolution you need: every step up in prescaler divides the ISR
+    //load by the same factor it multiplies the count period by.
+    static void print_config(Print& out)
+    {
+      out.print(F("Timer")); out.print(TIMER_ID);
+      out.print(F(", prescaler ")); out.print(PRESCALER);
+      out.print(F(": resolution = ")); out.print(COUNT_PERIOD_PS/1000.0, 4); out.print(F(" us"));
+      out.print(F(", overflow every ")); out.print(OVERFLOW_PERIOD_US); out.print(F(" us ("));
+      out.print(OVERFLOW_RATE_MILLIHZ/1000.0, 3); out.print(F(" ISR calls/sec)"));
+      out.print(F(", est. ISR CPU load = ")); out.print(OVF_ISR_LOAD_PPM/10000.0, 3); out.print(F("%"));
+      out.print(F(", get_count() rolls over every ")); out.print(ROLLOVER_SECONDS); out.println(F(" sec"));
+    }
+    #endif
+
+    //reset the counters back to 0
+    static inline void reset()
+    {
+      uint8_t SREG_old = SREG;
+      cli();
+      State::overflow_count = 0;
+      State::overflow_count_hi = 0;
+      Regs::tcnt() = 0;
+      Regs::tifr() = _BV(Regs::TOV_BIT); //clear a pending overflow so the ISR doesn't immediately count it
+      SREG = SREG_old;
+    }
+
+    //undo the configuration changes made in setup()
+    static inline void revert_to_normal()
+    {
+      overflow_interrupt_off();
+      Regs::tccra() = State::tccra_save;
+      Regs::tccrb() = State::tccrb_save;
+    }
+
+    //same as revert_to_normal()
+    static inline void unsetup()
+    {
+      revert_to_normal();
+    }
+
+    static inline void overflow_interrupt_off()
+    {
+      Regs::timsk() &= (uint8_t)~_BV(Regs::TOIE_BIT);
+    }
+
+    static inline void overflow_interrupt_on()
+    {
+      Regs::timsk() |= _BV(Regs::TOIE_BIT);
+    }
+
+    //called by the overflow ISR
+    static inline void increment_overflow_count()
+    {
+      uint32_t overflow_count = State::overflow_count + 1; //a local copy, so the volatile is read only once
+      State::overflow_count = overflow_count;
+      if (overflow_count == 0)
+        State::overflow_count_hi++;
+    }
+
+  private:
+    //Read TCNT & the overflow count consistently; interrupts MUST already be off.
+    //-if the overflow flag is set, the overflow hasn't been counted by the ISR yet, & TCNT may have just rolled over between 
+    // reading it & reading the flag, so TCNT is re-read, the overflow is counted here instead, & the flag is cleared so the 
+    // ISR won't count it a second time.  This is the fix for the 127.5us error described in eRCaGuy_Timer2_Counter.cpp.
+    static inline void read_counts(count_t& tcnt_save, uint32_t& overflow_count)
+    {
+      tcnt_save = Regs::tcnt();
+      overflow_count = State::overflow_count;
+      if (Regs::tifr() & _BV(Regs::TOV_BIT)) //overflow pending but not yet serviced by the ISR
+      {
+        tcnt_save = Regs::tcnt();
+        overflow_count++;
+        State::overflow_count = overflow_count;
+        if (overflow_count == 0)
+          State::overflow_count_hi++;
+        Regs::tifr() = _BV(Regs::TOV_BIT); //writing a 1 clears ONLY this flag (|= would also clear any other pending flags)
+      }
+    }
+};
+
+//Define the overflow ISR for TimerCounter<TIMER_ID,...>.  Use it once, at global scope, ex: TIMER_COUNTER_OVF_ISR(1);
+//Do NOT use it for Timer2 in an Arduino sketch, since the library already defines that ISR, for the "timer2" object.
+#if TIMER_COUNTER_FAST_OVF_ISR
+//The assembly version; it does exactly what increment_overflow_count() does.  ISR_NAKED means the compiler generates no register 
+//saves or restores at all, so the asm saves the only register (r24) & the only status flags (in SREG) it changes, & ends with its 
+//own "reti".  Its operands are the constant addresses of the overflow count variables, so it needs no registers from the compiler.
+//-overflow_count & then overflow_count_hi are incremented as one 6-byte little-endian number, 1 byte at a time: "inc" sets the Z 
+// flag when a byte rolls over to 0, which is exactly when the carry must go on to the next byte.
+//-the count bytes are written one at a time, but that's fine, since every reader reads them with interrupts off.
+#define TIMER_COUNTER_OVF_ISR(TIMER_ID) \
+  ISR(TIMER##TIMER_ID##_OVF_vect, ISR_NAKED) \
+  { \
+    __asm__ __volatile__( \
+      "push r24\n\t" \
+      "in   r24, __SREG__\n\t" \
+      "push r24\n\t" \
+      "lds  r24, %[ovf]\n\t" \
+      "inc  r24\n\t" \
+      "sts  %[ovf], r24\n\t" \
+      "brne 1f\n\t" \
+      "lds  r24, %[ovf]+1\n\t" \
+      "inc  r24\n\t" \
+      "sts  %[ovf]+1, r24\n\t" \
+      "brne 1f\n\t" \
+      "lds  r24, %[ovf]+2\n\t" \
+      "inc  r24\n\t" \
+      "sts  %[ovf]+2, r24\n\t" \
+      "brne 1f\n\t" \
+      "lds  r24, %[ovf]+3\n\t" \
+      "inc  r24\n\t" \
+      "sts  %[ovf]+3, r24\n\t" \
+      "brne 1f\n\t" \
+      "lds  r24, %[ovf_hi]\n\t" \
+      "inc  r24\n\t" \
+      "sts  %[ovf_hi], r24\n\t" \
+      "brne 1f\n\t" \
+      "lds  r24, %[ovf_hi]+1\n\t" \
+      "inc  r24\n\t" \
+      "sts  %[ovf_hi]+1, r24\n\t" \
+      "1:\n\t" \
+      "pop  r24\n\t" \
+      "out  __SREG__, r24\n\t" \
+      "pop  r24\n\t" \
+      "reti\n\t" \
+      : \
+      : [ovf] "i" (&TimerCounterState<TIMER_ID>::overflow_count), \
+        [ovf_hi] "i" (&TimerCounterState<TIMER_ID>::overflow_count_hi)); \
+  }
+#else
+//The C++ version; the fallback, & the one used in host (PC) builds
+#define TIMER_COUNTER_OVF_ISR(TIMER_ID) \
+  ISR(TIMER##TIMER_ID##_OVF_vect) \
+  { \
+    TimerCounter<TIMER_ID>::increment_overflow_count(); \
+  }
+#endif
+
+#endif
@@ -0,0 +1,198 @@
+/*
+eRCaGuy_TimerCounter_Durations
+-float-free time conversions for TimerCounter counts, with separate types for timestamps & for durations in each unit, so that
+ counts, microseconds, & nanoseconds can't be mixed up by accident, & so that no AVR soft-float code is needed at all
+-types:
+--Timestamp: an absolute get_count() value (it rolls over every 2^32 counts)
+--Ticks: a duration, in counts of the timer (0.5us each for the "timer2" object)
+--Micros & Nanos: durations in us & ns
+-subtracting 2 Timestamps gives the Ticks between them, & it is correct even across a get_count() rollover, as long as the real
+ time between them is < 2^32 counts (35.79 minutes @ 0.5us/count).
+-every conversion is value*NUM/DEN, where NUM/DEN is reduced at compile time from F_CPU & the prescaler.  When NUM & DEN are powers
+ of 2, as they are for every prescaler @ 16MHz & 8MHz, the conversion compiles down to a single shift (or nothing at all); ex:
+ Ticks-->Micros for the "timer2" object is ticks >> 1.  Otherwise it is a multiply by a constant (ex: Ticks-->Nanos is ticks*500),
+ plus, only when DEN is neither 1 nor a power of 2 (ex: F_CPU = 20MHz), an integer divide by a constant; still exact & float-free.
+-frequency: frequency_hz()/frequency_millihz() turn a period into a frequency with one integer division (COUNTS_PER_SECOND/period),
+ instead of 1000000.0/period_us.
+
+Basic usage:
+  #include <eRCaGuy_Timer2_Counter.h>
+  #include <eRCaGuy_TimerCounter_Durations.h>
+
+  Timestamp t_start = Timestamp::now(); //same as timer2.get_count()
+  ...
+  Ticks elapsed = Timestamp::now() - t_start;
+  unsigned long us = elapsed.to_micros().value;
+  unsigned long ns = elapsed.to_nanos().value;
+  unsigned long hz = elapsed.frequency_hz(); //if "elapsed" is a period
+
+Ranges (uint32_t, @ 0.5us/count): Ticks & Micros never overflow before get_count() rolls over; Nanos holds up to 4.29 seconds.
+
+For a timer or prescaler other than the "timer2" object's, use the templates directly, ex:
+  typedef TimerCounterTicks<TimerCounter<1,64> > Ticks1;
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#ifndef eRCaGuy_TimerCounter_Durations_h
+#define eRCaGuy_TimerCounter_Durations_h
+
+#include "eRCaGuy_TimerCounter.h"
+
+//---------------------------------------------------------------------------------------------------
+//value*NUM/DEN, with NUM/DEN reduced at compile time
+//---------------------------------------------------------------------------------------------------
+constexpr uint64_t timer_counter_gcd(uint64_t a, uint64_t b)
+{
+  return b == 0 ? a : timer_counter_gcd(b, a % b);
+}
+
+template <uint64_t NUM, uint64_t DEN>
+struct TimerCounterScale
+{
+  static const uint32_t N = (uint32_t)(NUM/timer_counter_gcd(NUM, DEN));
+  static const uint32_t D = (uint32_t)(DEN/timer_counter_gcd(NUM, DEN));
+  static_assert((uint64_t)N*D < (1ULL << 32), "TimerCounterScale: F_CPU & the prescaler give a ratio too fine for 32-bit math");
+
+  //floor(value*N/D), without the intermediate value*N overflowing: the remainder part is < D*N, which fits (see above).
+  //With N & D constants, "/ D" & "% D" become a shift & a mask when D is a power of 2, & "* N" a shift when N is.
+  static inline uint32_t apply(uint32_t value)
+  {
+    return (value / D)*N + ((value % D)*N) / D;
+  }
+};
+
+//---------------------------------------------------------------------------------------------------
+//Durations in fixed units; these don't depend on the timer
+//---------------------------------------------------------------------------------------------------
+struct Micros
+{
+  uint32_t value;
+  explicit Micros(uint32_t us = 0) : value(us) {}
+};
+
+struct Nanos
+{
+  uint32_t value;
+  explicit Nanos(uint32_t ns = 0) : value(ns) {}
+};
+
+//---------------------------------------------------------------------------------------------------
+//A duration in counts of COUNTER, ex: TimerCounter<2,8>
+//---------------------------------------------------------------------------------------------------
+template <typename COUNTER>
+struct TimerCounterTicks
+{
+  typedef TimerCounterScale<1000000ULL*COUNTER::PRESCALER_VALUE, F_CPU> ToMicros;
+  typedef TimerCounterScale<F_CPU, 1000000ULL*COUNTER::PRESCALER_VALUE> FromMicros;
+  typedef TimerCounterScale<1000000000ULL*COUNTER::PRESCALER_VALUE, F_CPU> ToNanos;
+  typedef TimerCounterScale<F_CPU, 1000000000ULL*COUNTER::PRESCALER_VALUE> FromNanos;
+
+  uint32_t value;
+
+  explicit TimerCounterTicks(uint32_t ticks = 0) : value(ticks) {}
+  TimerCounterTicks(Micros us) : value(FromMicros::apply(us.value)) {}
+  TimerCounterTicks(Nanos ns) : value(FromNanos::apply(ns.value)) {}
+
+  inline Micros to_micros() const { return Micros(ToMicros::apply(value)); } //rounded down
+  inline Nanos to_nanos() const { return Nanos(ToNanos::apply(value)); } //rounded down
+
+  //treating this duration as a period: frequency, rounded to the nearest Hz or mHz; 0 if the period is 0.
+  //frequency_millihz() saturates at 0xFFFFFFFF (4294967.295 Hz), ie: for periods of < COUNTS_PER_SECOND/4294967 counts, which
+  //only happens with a prescaler of 1 (at 16MHz, periods of 1 to 3 counts).
+  inline uint32_t frequency_hz() const
+  {
+    return value == 0 ? 0 : (COUNTER::COUNTS_PER_SECOND + value/2)/value;
+  }
+  inline uint32_t frequency_millihz() const
+  {
+    if (value == 0)
+      return 0;
+    //COUNTS_PER_SECOND*1000/value, split so nothing overflows 32 bits: whole Hz, then the remainder scaled to mHz
+    uint32_t hz = COUNTER::COUNTS_PER_SECOND/value;
+    uint32_t remainder = COUNTER::COUNTS_PER_SECOND%value;
+    if (remainder < 4294967UL) //remainder*1000 fits in 32 bits (always, when hz is large; value is tiny then)
+    {
+      uint32_t scaled = remainder*1000;
+      uint32_t millihz = scaled/value;
+      if (scaled % value >= value - scaled % value) //round to nearest, without adding value/2 to "scaled", which could overflow
+        millihz++;
+      if (hz > 4294967UL || (hz == 4294967UL && millihz > 295)) //hz*1000 + millihz would overflow 32 bits
+        return 0xFFFFFFFFUL;
+      return hz*1000 + millihz;
+    }
+    //only for periods > 4294967 counts (< 4Hz @ 16MHz w/no prescaler, < 1Hz @ 0.5us/count), so the 64-bit divide is rare
+    return hz*1000 + (uint32_t)(((uint64_t)remainder*1000 + value/2)/value);
+  }
+
+  inline TimerCounterTicks operator+(TimerCounterTicks other) const { return TimerCounterTicks(value + other.value); }
+  inline TimerCounterTicks operator-(TimerCounterTicks other) const { return TimerCounterTicks(value - other.value); }
+  inline TimerCounterTicks& operator+=(TimerCounterTicks other) { value += other.value; return *this; }
+  inline TimerCounterTicks& operator-=(TimerCounterTicks other) { value -= other.value; return *this; }
+  inline bool operator==(TimerCounterTicks other) const { return value == other.value; }
+  inline bool operator!=(TimerCounterTicks other) const { return value != other.value; }
+  inline bool operator<(TimerCounterTicks other) const { return value < other.value; }
+  inline bool operator>(TimerCounterTicks other) const { return value > other.value; }
+  inline bool operator<=(TimerCounterTicks other) const { return value <= other.value; }
+  inline bool operator>=(TimerCounterTicks other) const { return value >= other.value; }
+};
+
+//---------------------------------------------------------------------------------------------------
+//An absolute get_count() value of COUNTER
+//---------------------------------------------------------------------------------------------------
+template <typename COUNTER>
+struct TimerCounterTimestamp
+{
+  typedef TimerCounterTicks<COUNTER> ticks_t;
+
+  uint32_t count;
+
+  explicit TimerCounterTimestamp(uint32_t count_ = 0) : count(count_) {}
+
+  static inline TimerCounterTimestamp now() { return TimerCounterTimestamp(COUNTER::get_count()); }
+  static inline TimerCounterTimestamp now_in_isr() { return TimerCounterTimestamp(COUNTER::get_count_in_isr()); }
+
+  //time from "earlier" to this; unsigned subtraction is correct across a rollover of get_count()
+  inline ticks_t operator-(TimerCounterTimestamp earlier) const { return ticks_t(count - earlier.count); }
+  inline TimerCounterTimestamp operator+(ticks_t duration) const { return TimerCounterTimestamp(count + duration.value); }
+  inline TimerCounterTimestamp operator-(ticks_t duration) const { return TimerCounterTimestamp(count - duration.value); }
+
+  //true if this is later than "other", also across a rollover, as long as they are < 2^31 counts apart
+  inline bool is_after(TimerCounterTimestamp other) const { return (int32_t)(count - other.count) > 0; }
+  inline bool is_before(TimerCounterTimestamp other) const { return (int32_t)(count - other.count) < 0; }
+  inline bool operator==(TimerCounterTimestamp other) const { return count == other.count; }
+  inline bool operator!=(TimerCounterTimestamp other) const { return count != other.count; }
+
+  //time since this timestamp
+  inline ticks_t elapsed() const { return now() - *this; }
+};
+
+//the "timer2" object's timer & prescaler
+typedef TimerCounterTicks<TimerCounter<2,8> > Ticks;
+typedef TimerCounterTimestamp<TimerCounter<2,8> > Timestamp;
+
+#endif
@@ -0,0 +1,324 @@
+/*
+eRCaGuy_TimerCounter_Tickless
+-a "tickless" mode for a TimerCounter: while your code is polling get_count() in a tight loop, the overflow ISR is turned off,
+ so the loop isn't interrupted every overflow period (128us for the "timer2" object) & pays no ISR overhead at all, yet the
+ count stays correct over any interval, including when the polling stops
+-why it works: get_count() already counts a pending overflow itself (see read_counts() in eRCaGuy_TimerCounter.h), so the
+ overflow ISR isn't needed as long as get_count() is called at least once per overflow period.  The catch, until now, was
+ that a longer gap silently lost time, since the overflow flag can only hold 1 pending overflow.
+-how the gaps are covered: every poll of the count made through this object (get_count_unchecked() or get_count_checked())
+ also moves an output compare "watchdog" to half an overflow period after the current count.  While polling continues, it
+ never goes off.  If polling stops for longer than that, the watchdog ISR counts the pending overflow, turns the normal
+ overflow ISR back on, & turns itself off; the next poll turns the overflow ISR back off again & re-arms the watchdog.  Either
+ way, no overflow is ever left uncounted for more than half a period plus the interrupt latency.
+-lost overflows: if interrupts are kept off for longer than about an overflow period (ex: a long noInterrupts() section, or a
+ slow library ISR), neither the watchdog nor the overflow ISR can run, & the hardware loses overflows.  This can't be seen from
+ the timer itself, so this object compares the time it counted against an independent reference clock (micros() by default,
+ which runs on Timer0), every time the watchdog goes off, & in get_count_checked() & exit().  Any time found missing is
+ reported: get_count_checked() returns false from then on, & get_lost_overflow_count() says how many periods were lost,
+ until clear_lost_overflow_count() is called.  Without a reference clock (REFERENCE::AVAILABLE == false, the default when
+ not building for Arduino), nothing can be detected.
+-limits of the check: it can't see time lost by the reference clock itself (micros() also loses time if interrupts are off
+ for > 1ms), & it needs the overflow period to be well above the reference's resolution (4us for micros()), so it works for
+ prescalers >= 8 on Timer2, but not prescaler 1 (16us period).  Losses are only detected up to 35 minutes after the
+ previous check; a longer gap between checks is skipped, not judged.
+-cost: each get_count_unchecked() adds ~8 cycles over COUNTER::get_count() (a compare register write, a flag write,
+ & a check of whether the watchdog went off), vs. TIMER_COUNTER_OVF_ISR_CYCLES (28) every overflow period for the overflow ISR
+-the output compare channel used for the watchdog is this object's alone: it can't be shared with a TimerScheduler or a
+ LatencyProbe on the same timer, so pick the other channel for them
+
+Basic usage:
+  #include <eRCaGuy_Timer2_Counter.h>
+  #include <eRCaGuy_TimerCounter_Tickless.h>
+
+  TimerCounterTickless<> tickless; //Timer2, prescaler 8, output compare channel B
+  TIMER_COUNTER_TICKLESS_ISR(tickless, 2, B); //creates ISR(TIMER2_COMPB_vect) for it; put this at global scope, once
+
+  void setup() { timer2.setup(); }
+  void loop()
+  {
+    tickless.enter(); //overflow ISR off
+    while (polling)
+    {
+      unsigned long t = tickless.get_count_unchecked(); //NOT timer2.get_count(), which doesn't move the watchdog
+      ...
+    }
+    unsigned long t_end;
+    if (!tickless.get_count_checked(t_end))
+      ...overflows were lost, so t_end (& every count since the loss) is too small
+    tickless.exit(); //overflow ISR back on, as before enter()
+  }
+
+RAM: 14 bytes per object.
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#ifndef eRCaGuy_TimerCounter_Tickless_h
+#define eRCaGuy_TimerCounter_Tickless_h
+
+#include "eRCaGuy_TimerCounter.h"
+#include "eRCaGuy_TimerCounter_Durations.h"
+
+//Reference clocks for detecting lost overflows: a struct with a "static uint32_t micros()" that keeps counting (& wraps every
+//2^32 us) independently of the TimerCounter being checked, & "AVAILABLE" set to true
+#if defined(ARDUINO)
+//Arduino's micros(), on Timer0
+struct TimerCounterTicklessMicros
+{
+  static const bool AVAILABLE = true;
+  static inline uint32_t micros() { return ::micros(); }
+};
+#endif
+
+//no reference clock: lost overflows can't be detected
+struct TimerCounterTicklessNoReference
+{
+  static const bool AVAILABLE = false;
+  static inline uint32_t micros() { return 0; }
+};
+
+#if defined(ARDUINO)
+typedef TimerCounterTicklessMicros TimerCounterTicklessDefaultReference;
+#else
+typedef TimerCounterTicklessNoReference TimerCounterTicklessDefaultReference;
+#endif
+
+//Define the watchdog's compare match ISR for a TimerCounterTickless object.  Use it once, at global scope, ex:
+//TIMER_COUNTER_TICKLESS_ISR(tickless, 2, B);
+//-TIMER_ID & CHANNEL_LETTER (A or B) must match the object's COUNTER & CHANNEL; this is checked at compile time
+#define TIMER_COUNTER_TICKLESS_ISR(tickless, TIMER_ID, CHANNEL_LETTER) \
+  ISR(TIMER_COUNTER_COMPARE_VECT(TIMER_ID, CHANNEL_LETTER)) \
+  { \
+    static_assert(decltype(tickless)::TIMER_ID_VALUE == TIMER_ID && \
+                  decltype(tickless)::CHANNEL_VALUE == TIMER_COUNTER_CHANNEL_##CHANNEL_LETTER, \
+                  "TIMER_COUNTER_TICKLESS_ISR: the timer & channel must match the object's COUNTER & CHANNEL"); \
+    tickless.on_watchdog(); \
+  }
+
+//-COUNTER: the TimerCounter to run tickless; its setup() must be called first, & its overflow ISR must exist, since it's used
+// whenever polling stops
+//-CHANNEL: the output compare channel for the watchdog, TIMER_COUNTER_CHANNEL_A or TIMER_COUNTER_CHANNEL_B (the default)
+//-REFERENCE: the reference clock for detecting lost overflows; see above
+template <typename COUNTER = TimerCounter<2,8>, uint8_t CHANNEL = TIMER_COUNTER_CHANNEL_B,
+          typename REFERENCE = TimerCounterTicklessDefaultReference>
+class TimerCounterTickless
+{
+  private:
+    typedef TimerCounterRegs<COUNTER::TIMER_ID_VALUE> Regs;
+    typedef TimerCounterCompare<COUNTER::TIMER_ID_VALUE, CHANNEL> Compare;
+    typedef typename Regs::count_t count_t;
+
+    //the watchdog goes off this many counts after the last poll: the 2nd overflow after a poll (the first one the
+    //hardware can lose) comes at least COUNTS_PER_OVERFLOW + 1 counts after it, so this leaves > half a period for the
+    //watchdog ISR's latency
+    static const uint32_t WATCHDOG_COUNTS = COUNTER::COUNTS_PER_OVERFLOW/2;
+    //the longest time between 2 checks that can still be judged: less than both get_count()'s & the reference's rollover
+    static const uint32_t MAX_CHECK_US = COUNTER::ROLLOVER_SECONDS < 4294 ? COUNTER::ROLLOVER_SECONDS*1000000UL : 0xFFFFFFFFUL;
+
+  public:
+    static const uint8_t TIMER_ID_VALUE = COUNTER::TIMER_ID_VALUE;
+    static const uint8_t CHANNEL_VALUE = CHANNEL;
+
+    TimerCounterTickless() : _active(false), _watchdog_tripped(false), _lost_overflows(0), _watchdog_count(0),
+                             _check_count(0), _check_us(0)
+    {
+    }
+
+    //start tickless mode: turn the overflow ISR off & arm the watchdog
+    void enter()
+    {
+      uint8_t SREG_old = SREG;
+      cli();
+      uint32_t count = COUNTER::get_count_in_isr(); //counts a pending overflow, before its ISR is turned off
+      COUNTER::overflow_interrupt_off();
+      _watchdog_tripped = false;
+      move_watchdog((count_t)count);
+      Compare::interrupt_on();
+      _active = true;
+      _check_count = count;
+      _check_us = REFERENCE::micros();
+      SREG = SREG_old;
+    }
+
+    //end tickless mode: check for lost overflows one last time, turn the watchdog off, & turn the overflow ISR back on
+    void exit()
+    {
+      uint8_t SREG_old = SREG;
+      cli();
+      if (_active)
+      {
+        check(COUNTER::get_count_in_isr());
+        Compare::interrupt_off();
+        Compare::clear_flag();
+        COUNTER::overflow_interrupt_on();
+        _watchdog_tripped = false;
+        _active = false;
+      }
+      SREG = SREG_old;
+    }
+
+    inline bool is_active() const { return _active; }
+
+    //same as COUNTER::get_count(), & it also moves the watchdog forward; use it for ALL polling while in tickless mode.
+    //UNCHECKED: if the hardware lost overflows (see "lost overflows" above), the count is short, & nothing says so until the next
+    //check (the watchdog going off, get_count_checked(), or exit()).  That's why it isn't named plain get_count(): checking on
+    //every call would cost a REFERENCE::micros() call per poll, so call get_count_checked() now & then instead.
+    inline uint32_t get_count_unchecked()
+    {
+      uint8_t SREG_old = SREG;
+      cli();
+      uint32_t count = poll();
+      SREG = SREG_old;
+      return count;
+    }
+
+    //same as get_count_unchecked(), for use ONLY where interrupts are already off, ex: in an ISR
+    inline uint32_t get_count_unchecked_in_isr()
+    {
+      return poll();
+    }
+
+    //same as get_count_unchecked(), but also checks for lost overflows against the reference clock, which is slower (a call to
+    //REFERENCE::micros()).  Returns false if any have been lost since enter() or the last clear_lost_overflow_count(), in which
+    //case "count" is short by at least get_lost_overflow_count() overflow periods.  Call it at least once every 35 minutes or
+    //so, or losses in between can't be judged.
+    bool get_count_checked(uint32_t& count)
+    {
+      uint8_t SREG_old = SREG;
+      cli();
+      count = poll();
+      if (_active)
+        check(count);
+      bool ok = _lost_overflows == 0;
+      SREG = SREG_old;
+      return ok;
+    }
+
+    //the # of overflows found lost so far; it stays set (saturating at 65535) until cleared
+    uint16_t get_lost_overflow_count() const
+    {
+      uint8_t SREG_old = SREG;
+      cli();
+      uint16_t lost = _lost_overflows;
+      SREG = SREG_old;
+      return lost;
+    }
+
+    void clear_lost_overflow_count()
+    {
+      uint8_t SREG_old = SREG;
+      cli();
+      _lost_overflows = 0;
+      SREG = SREG_old;
+    }
+
+    //the # of times polling stopped for long enough that the watchdog went off & turned the overflow ISR back on (saturating at
+    //65535); if this climbs quickly, the loop is too slow for tickless mode to save anything
+    uint16_t get_watchdog_count() const
+    {
+      uint8_t SREG_old = SREG;
+      cli();
+      uint16_t watchdog_count = _watchdog_count;
+      SREG = SREG_old;
+      return watchdog_count;
+    }
+
+    //true while the overflow ISR is off, ie: in tickless mode & polling often enough that the watchdog hasn't gone off since the
+    //last get_count_unchecked()
+    inline bool is_polling() const { return _active && !_watchdog_tripped; }
+
+    //called by the watchdog's compare match ISR (see TIMER_COUNTER_TICKLESS_ISR); interrupts must be off
+    void on_watchdog()
+    {
+      uint32_t count = COUNTER::get_count_in_isr(); //counts the overflow the polling would have
+      COUNTER::overflow_interrupt_on(); //& counts the rest the usual way, until polling starts again
+      Compare::interrupt_off();
+      _watchdog_tripped = true;
+      if (_watchdog_count != 0xFFFF)
+        _watchdog_count++;
+      check(count);
+    }
+
+  private:
+    //get the count, & push the watchdog back; interrupts must be off
+    inline uint32_t poll()
+    {
+      uint32_t count = COUNTER::get_count_in_isr(); //counts a pending overflow, if any
+      if (_watchdog_tripped) //polling has started again since the watchdog went off
+      {
+        COUNTER::overflow_interrupt_off(); //no overflow is pending, since it was just counted above
+        Compare::interrupt_on();
+        _watchdog_tripped = false;
+      }
+      move_watchdog((count_t)count);
+      return count;
+    }
+
+    //arm the watchdog to go off WATCHDOG_COUNTS after "now", the low bits of the count (ie: TCNT) just read
+    static inline void move_watchdog(count_t now)
+    {
+      Compare::ocr() = (count_t)(now + WATCHDOG_COUNTS - 1); //OCFnx is set as TCNTn counts from OCRnx to OCRnx + 1
+      Compare::clear_flag(); //after writing OCRnx, so a match on the old value can't set it off
+    }
+
+    //compare the time counted since the last check with the reference clock's; interrupts must be off
+    //-any shortfall of more than half an overflow period is lost overflows, rounded to the nearest whole period
+    //-the count may even have gone BACK (by < 1 period) since the last check: if an overflow is already pending (after
+    // interrupts were off for ~a period), & the next one comes between that check's read of the overflow flag & its clearing
+    // of it, the hardware loses the 2nd one AFTER the last check read the count
+    void check(uint32_t count)
+    {
+      if (!REFERENCE::AVAILABLE)
+        return;
+      uint32_t now_us = REFERENCE::micros();
+      uint32_t reference_us = now_us - _check_us;
+      if (reference_us <= MAX_CHECK_US)
+      {
+        int32_t counted = (int32_t)(count - _check_count);
+        uint32_t counted_us = TimerCounterTicks<COUNTER>(counted < 0 ? (uint32_t)-counted : (uint32_t)counted).to_micros().value;
+        uint32_t shortfall_us = counted < 0 ? reference_us + counted_us :
+                                reference_us > counted_us ? reference_us - counted_us : 0;
+        if (shortfall_us > COUNTER::OVERFLOW_PERIOD_US/2)
+        {
+          uint32_t lost = (shortfall_us + COUNTER::OVERFLOW_PERIOD_US/2)/COUNTER::OVERFLOW_PERIOD_US;
+          _lost_overflows = lost >= (uint32_t)(0xFFFF - _lost_overflows) ? 0xFFFF : (uint16_t)(_lost_overflows + lost);
+        }
+      }
+      _check_count = count;
+      _check_us = now_us;
+    }
+
+    volatile bool _active;
+    volatile bool _watchdog_tripped; //the watchdog went off, so the overflow ISR is on until the next poll
+    volatile uint16_t _lost_overflows;
+    volatile uint16_t _watchdog_count;
+    uint32_t _check_count; //the count & the reference time at the last check
+    uint32_t _check_us;
+};
+
+#endif
@@ -0,0 +1,269 @@
+/*
+eRCaGuy_TimerCounter_mock
+-host (PC) register backend for eRCaGuy_TimerCounter.h, so the TimerCounter templates can be compiled and unit-tested on Linux
+ with a normal g++, with no AVR toolchain and no Arduino board.
+-each AVR register used by this library is replaced by a variable in RAM of the same width, with the same name, so the
+ exact same template code that runs on the ATmega328 runs on the host.  Nothing "ticks" on its own here: a test program sets
+ TCNT2, etc. itself, then calls the library and checks the result.
+-the interrupt flag registers (TIFRn) are write-1-to-clear, as on the AVR: TIFR2 = _BV(TOV2) clears TOV2, & TIFR2 |= x clears
+ every flag that was set.  To SET a flag, as the hardware would, use TIFR2.hw_write(TIFR2.hw_read() | _BV(TOV2)).
+-access hook: if TimerCounterMockHook<>::before_access is set, it is called just before every read & write of a mocked register,
+ & before every byte read or written of the library's ISR-shared variables (see TimerCounterMockShared).  Those are the points
+ where, on the AVR, the timer could tick or an interrupt could fire between 2 instructions, so a simulator can use the hook to
+ advance time & dispatch ISRs there; see extras/timer_counter_sim/.  hw_read() & hw_write() never call the hook.
+-ISR(vector) becomes an ordinary extern "C" function, so a test can "fire" an interrupt simply by calling it, ex: TIMER2_OVF_vect();
+
+This file is included automatically by eRCaGuy_TimerCounter.h whenever __AVR__ is NOT defined.  Do not include it in a sketch.
+
+Example host build:
+  g++ -std=gnu++11 -Wall -I path/to/eRCaGuy_TimerCounter my_host_test.cpp
+
+Register names, bit numbers, & vector numbers are those of the ATmega328/328P; see the datasheet, "Register Summary" &
+"Interrupts" sections.
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#ifndef eRCaGuy_TimerCounter_mock_h
+#define eRCaGuy_TimerCounter_mock_h
+
+#include <stdint.h>
+
+#ifndef F_CPU
+ #define F_CPU 16000000UL //same as an Arduino Uno/Nano/Pro Mini 5V
+#endif
+
+#ifndef _BV
+ #define _BV(bit) (1 << (bit))
+#endif
+
+//Called (if not NULL) just before every access to a mocked register or shared variable; "address" is the register or variable
+//accessed.  Static members of a class template, like the registers below, so it can be defined here in the header.
+template <int UNUSED = 0>
+struct TimerCounterMockHook
+{
+  static void (*before_access)(const void* address, bool is_write);
+};
+template <int UNUSED> void (*TimerCounterMockHook<UNUSED>::before_access)(const void* address, bool is_write) = 0;
+
+#define TIMER_COUNTER_MOCK_ACCESS(address, is_write) \
+  do { if (TimerCounterMockHook<>::before_access) TimerCounterMockHook<>::before_access(address, is_write); } while (0)
+
+//A register that is just a variable.  The operators below are the only ones the library applies to registers; |= & &= are a
+//separate read & write, as on the AVR (except sbi()/cbi(), which are single instructions).
+template <typename T>
+class TimerCounterMockReg
+{
+  public:
+    explicit TimerCounterMockReg(bool write_1_to_clear = false) : _value(0), _write_1_to_clear(write_1_to_clear) {}
+    operator T() const { TIMER_COUNTER_MOCK_ACCESS(this, false); return _value; }
+    TimerCounterMockReg& operator=(T value) { TIMER_COUNTER_MOCK_ACCESS(this, true); write(value); return *this; }
+    TimerCounterMockReg& operator|=(T value) { T old = *this; return *this = old | value; }
+    TimerCounterMockReg& operator&=(T value) { T old = *this; return *this = old & value; }
+    void sbi(uint8_t bit) { TIMER_COUNTER_MOCK_ACCESS(this, true); write(_write_1_to_clear ? _BV(bit) : _value | _BV(bit)); }
+    void cbi(uint8_t bit) { TIMER_COUNTER_MOCK_ACCESS(this, true); if (!_write_1_to_clear) _value &= (T)~_BV(bit); }
+    //what the hardware itself sees & does: no hook, & no write-1-to-clear
+    T hw_read() const { return _value; }
+    void hw_write(T value) { _value = value; }
+  private:
+    void write(T value) { _value = _write_1_to_clear ? (T)(_value & ~value) : value; }
+    T _value;
+    bool _write_1_to_clear;
+};
+
+//A variable shared between an ISR & the main code, ex: the overflow count.  Like the AVR, which has no multi-byte loads or stores,
+//it is read & written 1 byte at a time (least significant first), with the access hook called before each byte, so a simulator
+//can fire an interrupt in the middle of a multi-byte access.
+template <typename T>
+class TimerCounterMockShared
+{
+  public:
+    TimerCounterMockShared(T value = 0) : _value(value) {}
+    operator T() const
+    {
+      T value = 0;
+      for (uint8_t i = 0; i < sizeof(T); i++)
+      {
+        TIMER_COUNTER_MOCK_ACCESS(this, false);
+        value |= (T)((_value >> 8*i) & 0xFF) << 8*i;
+      }
+      return value;
+    }
+    TimerCounterMockShared& operator=(T value)
+    {
+      for (uint8_t i = 0; i < sizeof(T); i++)
+      {
+        TIMER_COUNTER_MOCK_ACCESS(this, true);
+        _value = (_value & ~((T)0xFF << 8*i)) | (value & ((T)0xFF << 8*i));
+      }
+      return *this;
+    }
+    T operator++(int) { T value = *this; *this = value + 1; return value; }
+    T hw_read() const { return _value; }
+    void hw_write(T value) { _value = value; }
+  private:
+    T _value;
+};
+
+//X-macro lists of every mocked register
+#define TIMER_COUNTER_MOCK_REGS8(X) \
+  X(SREG) \
+  X(TCCR0A) X(TCCR0B) X(TCNT0) X(OCR0A) X(OCR0B) X(TIMSK0) \
+  X(TCCR1A) X(TCCR1B) X(TIMSK1) \
+  X(TCCR2A) X(TCCR2B) X(TCNT2) X(OCR2A) X(OCR2B) X(TIMSK2) \
+  X(PCICR) X(PCMSK0) X(PCMSK1) X(PCMSK2) X(PINB) X(PINC) X(PIND)
+#define TIMER_COUNTER_MOCK_FLAG_REGS8(X) \
+  X(TIFR0) X(TIFR1) X(TIFR2)
+#define TIMER_COUNTER_MOCK_REGS16(X) \
+  X(TCNT1) X(OCR1A) X(OCR1B)
+
+//The registers themselves.  They are static members of a class template only so that they can be defined right here in the
+//header without multiple-definition link errors when several host .cpp files include it.
+template <int UNUSED = 0>
+struct TimerCounterMockIo
+{
+  #define TIMER_COUNTER_MOCK_DECLARE8(name) static TimerCounterMockReg<uint8_t> reg_##name;
+  #define TIMER_COUNTER_MOCK_DECLARE16(name) static TimerCounterMockReg<uint16_t> reg_##name;
+  TIMER_COUNTER_MOCK_REGS8(TIMER_COUNTER_MOCK_DECLARE8)
+  TIMER_COUNTER_MOCK_FLAG_REGS8(TIMER_COUNTER_MOCK_DECLARE8)
+  TIMER_COUNTER_MOCK_REGS16(TIMER_COUNTER_MOCK_DECLARE16)
+  #undef TIMER_COUNTER_MOCK_DECLARE8
+  #undef TIMER_COUNTER_MOCK_DECLARE16
+
+  //set every mocked register back to 0, as at power-up; call this at the start of each test
+  static void reset_all()
+  {
+    #define TIMER_COUNTER_MOCK_RESET(name) reg_##name.hw_write(0);
+    TIMER_COUNTER_MOCK_REGS8(TIMER_COUNTER_MOCK_RESET)
+    TIMER_COUNTER_MOCK_FLAG_REGS8(TIMER_COUNTER_MOCK_RESET)
+    TIMER_COUNTER_MOCK_REGS16(TIMER_COUNTER_MOCK_RESET)
+    #undef TIMER_COUNTER_MOCK_RESET
+  }
+};
+#define TIMER_COUNTER_MOCK_DEFINE8(name) template <int UNUSED> TimerCounterMockReg<uint8_t> TimerCounterMockIo<UNUSED>::reg_##name;
+#define TIMER_COUNTER_MOCK_DEFINE16(name) template <int UNUSED> TimerCounterMockReg<uint16_t> TimerCounterMockIo<UNUSED>::reg_##name;
+#define TIMER_COUNTER_MOCK_DEFINE_FLAGS8(name) template <int UNUSED> TimerCounterMockReg<uint8_t> TimerCounterMockIo<UNUSED>::reg_##name(true);
+TIMER_COUNTER_MOCK_REGS8(TIMER_COUNTER_MOCK_DEFINE8)
+TIMER_COUNTER_MOCK_FLAG_REGS8(TIMER_COUNTER_MOCK_DEFINE_FLAGS8)
+TIMER_COUNTER_MOCK_REGS16(TIMER_COUNTER_MOCK_DEFINE16)
+#undef TIMER_COUNTER_MOCK_DEFINE8
+#undef TIMER_COUNTER_MOCK_DEFINE_FLAGS8
+#undef TIMER_COUNTER_MOCK_DEFINE16
+
+//give every register its AVR name
+#define SREG   (TimerCounterMockIo<>::reg_SREG)
+#define TCCR0A (TimerCounterMockIo<>::reg_TCCR0A)
+#define TCCR0B (TimerCounterMockIo<>::reg_TCCR0B)
+#define TCNT0  (TimerCounterMockIo<>::reg_TCNT0)
+#define OCR0A  (TimerCounterMockIo<>::reg_OCR0A)
+#define OCR0B  (TimerCounterMockIo<>::reg_OCR0B)
+#define TIFR0  (TimerCounterMockIo<>::reg_TIFR0)
+#define TIMSK0 (TimerCounterMockIo<>::reg_TIMSK0)
+#define TCCR1A (TimerCounterMockIo<>::reg_TCCR1A)
+#define TCCR1B (TimerCounterMockIo<>::reg_TCCR1B)
+#define TCNT1  (TimerCounterMockIo<>::reg_TCNT1)
+#define OCR1A  (TimerCounterMockIo<>::reg_OCR1A)
+#define OCR1B  (TimerCounterMockIo<>::reg_OCR1B)
+#define TIFR1  (TimerCounterMockIo<>::reg_TIFR1)
+#define TIMSK1 (TimerCounterMockIo<>::reg_TIMSK1)
+#define TCCR2A (TimerCounterMockIo<>::reg_TCCR2A)
+#define TCCR2B (TimerCounterMockIo<>::reg_TCCR2B)
+#define TCNT2  (TimerCounterMockIo<>::reg_TCNT2)
+#define OCR2A  (TimerCounterMockIo<>::reg_OCR2A)
+#define OCR2B  (TimerCounterMockIo<>::reg_OCR2B)
+#define TIFR2  (TimerCounterMockIo<>::reg_TIFR2)
+#define TIMSK2 (TimerCounterMockIo<>::reg_TIMSK2)
+#define PCICR  (TimerCounterMockIo<>::reg_PCICR)
+#define PCMSK0 (TimerCounterMockIo<>::reg_PCMSK0)
+#define PCMSK1 (TimerCounterMockIo<>::reg_PCMSK1)
+#define PCMSK2 (TimerCounterMockIo<>::reg_PCMSK2)
+#define PINB   (TimerCounterMockIo<>::reg_PINB)
+#define PINC   (TimerCounterMockIo<>::reg_PINC)
+#define PIND   (TimerCounterMockIo<>::reg_PIND)
+
+//bit numbers; identical for Timer0, Timer1, & Timer2 unless noted
+#define SREG_I 7
+#define TOV0   0
+#define OCF0A  1
+#define OCF0B  2
+#define TOIE0  0
+#define OCIE0A 1
+#define OCIE0B 2
+#define TOV1   0
+#define OCF1A  1
+#define OCF1B  2
+#define TOIE1  0
+#define OCIE1A 1
+#define OCIE1B 2
+#define TOV2   0
+#define OCF2A  1
+#define OCF2B  2
+#define TOIE2  0
+#define OCIE2A 1
+#define OCIE2B 2
+#define WGM00  0
+#define WGM01  1
+#define WGM02  3
+#define WGM10  0
+#define WGM11  1
+#define WGM12  3
+#define WGM13  4 //Timer1 only
+#define WGM20  0
+#define WGM21  1
+#define WGM22  3
+#define CS00   0
+#define CS01   1
+#define CS02   2
+#define CS10   0
+#define CS11   1
+#define CS12   2
+#define CS20   0
+#define CS21   1
+#define CS22   2
+
+//global interrupt enable/disable act on the mocked SREG's I bit, exactly as on the AVR (each is a single instruction)
+static inline void cli() { SREG.cbi(SREG_I); }
+static inline void sei() { SREG.sbi(SREG_I); }
+
+//interrupt vectors; the same __vector_N numbers as avr-libc uses for the ATmega328
+#define PCINT0_vect       __vector_3
+#define PCINT1_vect       __vector_4
+#define PCINT2_vect       __vector_5
+#define TIMER2_COMPA_vect __vector_7
+#define TIMER2_COMPB_vect __vector_8
+#define TIMER2_OVF_vect   __vector_9
+#define TIMER1_COMPA_vect __vector_11
+#define TIMER1_COMPB_vect __vector_12
+#define TIMER1_OVF_vect   __vector_13
+#define TIMER0_COMPA_vect __vector_14
+#define TIMER0_COMPB_vect __vector_15
+#define TIMER0_OVF_vect   __vector_16
+
+//an ISR is just a function a test can call
+#define ISR(vector, ...) extern "C" void vector(void); extern "C" void vector(void)
+
+#endif
@@ -0,0 +1,432 @@
+/*
+eRCaGuy_TimerScheduler
+-software timers on top of a TimerCounter: call a function at an absolute get_count() deadline (0.5us resolution with the "timer2"
+ object's Timer2 @ prescaler 8), or after a delay, ex: "set pin 13 high exactly 1000us after this edge"
+-it uses one of the timer's output compare channels (OCRnA or OCRnB) & its compare match interrupt, alongside the overflow count
+ the TimerCounter already keeps.  The compare register is programmed only for the NEXT wake-up, never for every count.
+-pending timers sit in a fixed-capacity "hashed timing wheel": NUM_SLOTS lists, one per overflow period (256 counts = 128us on
+ Timer2 @ prescaler 8), reused round-robin, so schedule_at() & cancel() are O(1) (no sorting), & finding the next deadline only
+ looks at the NUM_SLOTS lists.  Timers further out than NUM_SLOTS periods simply wait in their slot for later rounds.
+-no dynamic memory allocation: CAPACITY timers, 12 bytes each, + NUM_SLOTS + 12 bytes of RAM; ex: TimerScheduler<> uses
+ 8*12 + 16 + 12 = 124 bytes
+
+Basic usage:
+  #include <eRCaGuy_Timer2_Counter.h>
+  #include <eRCaGuy_TimerScheduler.h>
+
+  TimerScheduler<> scheduler; //Timer2, prescaler 8, output compare channel A, up to 8 pending timers
+  TIMER_SCHEDULER_ISR(scheduler, 2, A); //creates ISR(TIMER2_COMPA_vect) for it; put this at global scope, once
+
+  void pulseEnd(void* arg) { digitalWrite(13, LOW); }
+
+  void setup() { timer2.setup(); pinMode(13, OUTPUT); }
+  void loop()
+  {
+    ...
+    digitalWrite(13, HIGH);
+    scheduler.schedule_in(2000, pulseEnd); //2000 counts = 1000us from now
+  }
+
+How a deadline is met: the compare match is set for a little BEFORE the deadline (the lead: TIMER_SCHEDULER_LEAD_CYCLES), to
+cover the interrupt's entry time; the ISR then waits in a tight loop on TCNT for the exact count & calls the callback, so every
+callback runs a fixed, short time after its deadline, with a jitter of about 1 count, instead of after however long the ISR took
+to get going.  A deadline closer than the lead is handled the same way, right away.
+
+CPU load: on an 8-bit timer, the compare register holds only the low byte of the wake-up count, so the compare match interrupt
+fires once per overflow period whenever ANY timer is pending; each early wake-up just compares the count with the wake-up count &
+returns (~ the cost of the overflow ISR).  With no timers pending, the compare match interrupt is off & costs nothing.
+
+Callbacks:
+-are plain functions, void callback(void* arg); arg is whatever was passed to schedule_at()/schedule_in()
+-run INSIDE the compare match ISR, with interrupts off, so keep them short (every microsecond spent in one delays the next
+ timer, & the overflow ISR)
+-may schedule & cancel timers, including re-scheduling themselves, ex: for a drift-free periodic timer, schedule the next run at
+ this run's deadline + the period, not at get_count() + the period
+
+Rules:
+-a deadline must be less than 2^31 counts (17.9 minutes @ 0.5us/count) away from the count at which it is scheduled; one
+ already in the past runs as soon as possible
+-do NOT call the counter's reset() while timers are pending: every pending deadline would then be ~35 minutes away
+-the compare channel is the scheduler's alone: on Timer2, don't use tone() (it uses TIMER2_COMPA_vect), nor analogWrite() on
+ pin 11 (OC2A) or pin 3 (OC2B), which also change the timer's mode
+-schedule_at(), schedule_in(), cancel(), etc. may be called from loop() or from any ISR
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#ifndef eRCaGuy_TimerScheduler_h
+#define eRCaGuy_TimerScheduler_h
+
+#include "eRCaGuy_TimerCounter.h"
+
+//CPU cycles from the compare match to the point in the ISR where it starts waiting for the deadline (interrupt response, vector
+//jump, register pushes, & reading the count), with some margin; the compare match is set this much before each deadline.
+//-you may #define your own value before including this file
+#ifndef TIMER_SCHEDULER_LEAD_CYCLES
+ #define TIMER_SCHEDULER_LEAD_CYCLES 128
+#endif
+
+//CPU cycles needed to program the compare register; a wake-up closer than this (+ 2 counts) is not programmed, but waited for
+#ifndef TIMER_SCHEDULER_ARM_CYCLES
+ #define TIMER_SCHEDULER_ARM_CYCLES 32
+#endif
+
+//Define the compare match ISR for a TimerScheduler object.  Use it once, at global scope, ex: TIMER_SCHEDULER_ISR(scheduler, 2, A);
+//-TIMER_ID & CHANNEL_LETTER (A or B) must match the scheduler's COUNTER & CHANNEL; this is checked at compile time
+#define TIMER_SCHEDULER_ISR(scheduler, TIMER_ID, CHANNEL_LETTER) \
+  ISR(TIMER_COUNTER_COMPARE_VECT(TIMER_ID, CHANNEL_LETTER)) \
+  { \
+    static_assert(decltype(scheduler)::TIMER_ID_VALUE == TIMER_ID && \
+                  decltype(scheduler)::CHANNEL_VALUE == TIMER_COUNTER_CHANNEL_##CHANNEL_LETTER, \
+                  "TIMER_SCHEDULER_ISR: the timer & channel must match the scheduler's COUNTER & CHANNEL"); \
+    scheduler.on_compare_match(); \
+  }
+
+//-CAPACITY: the max # of timers pending at once (1 to 254)
+//-COUNTER: the TimerCounter whose get_count() the deadlines are in; its setup() must be called first
+//-CHANNEL: the output compare channel to use, TIMER_COUNTER_CHANNEL_A or TIMER_COUNTER_CHANNEL_B
+//-NUM_SLOTS: the # of overflow periods in one turn of the wheel, a power of 2 from 4 to 128; more slots = fewer timers per slot to
+// look through, at the cost of 1 byte each
+template <uint8_t CAPACITY = 8, typename COUNTER = TimerCounter<2,8>, uint8_t CHANNEL = TIMER_COUNTER_CHANNEL_A,
+          uint8_t NUM_SLOTS = 16>
+class TimerScheduler
+{
+  static_assert(CAPACITY >= 1 && CAPACITY <= 254, "TimerScheduler: CAPACITY must be 1 to 254");
+  static_assert(NUM_SLOTS >= 4 && NUM_SLOTS <= 128 && (NUM_SLOTS & (NUM_SLOTS - 1)) == 0,
+                "TimerScheduler: NUM_SLOTS must be a power of 2, from 4 to 128");
+
+  private:
+    typedef TimerCounterRegs<COUNTER::TIMER_ID_VALUE> Regs;
+    typedef TimerCounterCompare<COUNTER::TIMER_ID_VALUE, CHANNEL> Compare;
+    typedef typename Regs::count_t count_t;
+
+  public:
+    typedef void (*callback_t)(void* arg);
+    typedef uint16_t handle_t; //(generation << 8) | index, so a stale handle can't cancel a newer timer in the same place
+    static const handle_t NO_TIMER = 0xFFFF;
+
+    static const uint8_t TIMER_ID_VALUE = COUNTER::TIMER_ID_VALUE;
+    static const uint8_t CHANNEL_VALUE = CHANNEL;
+    static const uint32_t LEAD_COUNTS = (TIMER_SCHEDULER_LEAD_CYCLES + COUNTER::PRESCALER_VALUE - 1)/COUNTER::PRESCALER_VALUE;
+    static const uint32_t MIN_ARM_COUNTS = (TIMER_SCHEDULER_ARM_CYCLES + COUNTER::PRESCALER_VALUE - 1)/COUNTER::PRESCALER_VALUE + 2;
+
+    TimerScheduler() : _free(0), _pending(0), _next_timer(NONE), _in_service(false), _wake_count(0), _scan_count(0)
+    {
+      for (uint8_t i = 0; i < CAPACITY; i++)
+      {
+        _next[i] = i + 1 < CAPACITY ? i + 1 : NONE;
+        _slot[i] = NONE;
+        _generation[i] = 0;
+      }
+      for (uint8_t slot = 0; slot < NUM_SLOTS; slot++)
+        _head[slot] = NONE;
+    }
+
+    //call callback(arg) at count "deadline" (in COUNTER::get_count() units); returns a handle for cancel(), or NO_TIMER if
+    //CAPACITY timers are already pending
+    handle_t schedule_at(uint32_t deadline, callback_t callback, void* arg = 0)
+    {
+      uint8_t SREG_old = SREG;
+      cli();
+      handle_t handle = insert(deadline, callback, arg);
+      SREG = SREG_old;
+      return handle;
+    }
+
+    //call callback(arg) "delay" counts from now
+    handle_t schedule_in(uint32_t delay, callback_t callback, void* arg = 0)
+    {
+      uint8_t SREG_old = SREG;
+      cli();
+      handle_t handle = insert(COUNTER::get_count_in_isr() + delay, callback, arg);
+      SREG = SREG_old;
+      return handle;
+    }
+
+    //cancel a pending timer, in O(1); returns false if it already ran, was already cancelled, or handle is NO_TIMER
+    bool cancel(handle_t handle)
+    {
+      uint8_t SREG_old = SREG;
+      cli();
+      bool pending = is_pending_in_isr(handle);
+      if (pending)
+      {
+        uint8_t i = (uint8_t)handle;
+        unlink(i);
+        release(i);
+        if (i == _next_timer)
+          _next_timer = NONE; //the compare match stays set; that wake-up will just find the next timer
+        if (_pending == 0 && !_in_service)
+          Compare::interrupt_off();
+      }
+      SREG = SREG_old;
+      return pending;
+    }
+
+    bool is_pending(handle_t handle) const
+    {
+      uint8_t SREG_old = SREG;
+      cli();
+      bool pending = is_pending_in_isr(handle);
+      SREG = SREG_old;
+      return pending;
+    }
+
+    //# of timers pending
+    inline uint8_t pending_count() const { return _pending; }
+
+    //called by the compare match ISR (see TIMER_SCHEDULER_ISR); interrupts must be off
+    inline void on_compare_match()
+    {
+      uint32_t now = COUNTER::get_count_in_isr();
+      if ((int32_t)(now - _wake_count) < 0)
+        return; //the compare matched in an earlier overflow period than the wake-up's; nothing to do yet
+      service(now);
+    }
+
+  private:
+    static const uint8_t NONE = 0xFF;
+    static const uint8_t PERIOD_BITS = Regs::COUNTER_BITS;
+    static const uint32_t COUNTS_PER_PERIOD = 1UL << PERIOD_BITS;
+
+    static inline uint8_t slot_of(uint32_t count) { return (uint8_t)(count >> PERIOD_BITS) & (NUM_SLOTS - 1); }
+    static inline uint32_t period_start(uint32_t count) { return count & ~(COUNTS_PER_PERIOD - 1); }
+
+    inline bool is_pending_in_isr(handle_t handle) const
+    {
+      uint8_t i = (uint8_t)handle;
+      return i < CAPACITY && _slot[i] != NONE && _generation[i] == (uint8_t)(handle >> 8);
+    }
+
+    //interrupts must be off
+    handle_t insert(uint32_t deadline, callback_t callback, void* arg)
+    {
+      uint8_t i = _free;
+      if (i == NONE)
+        return NO_TIMER;
+      _free = _next[i];
+      if (_pending == 0 && !_in_service)
+        _scan_count = period_start(COUNTER::get_count_in_isr()); //the wheel has been idle; bring it up to date
+      _pending++;
+      _deadline[i] = deadline;
+      _callback[i] = callback;
+      _arg[i] = arg;
+      //a deadline before the period the wheel has already been looked through up to goes in that period's slot instead, so it is
+      //seen (& run) at the next look
+      link(i, (int32_t)(deadline - _scan_count) < 0 ? slot_of(_scan_count) : slot_of(deadline));
+
+      //while in service(), the next wake-up is worked out once all due timers have run
+      if (!_in_service && (!Compare::interrupt_is_on() || (int32_t)(deadline - LEAD_COUNTS - _wake_count) < 0))
+      {
+        uint32_t now = COUNTER::get_count_in_isr();
+        uint32_t wake = deadline - LEAD_COUNTS;
+        uint32_t margin = MIN_ARM_COUNTS;
+        if ((int32_t)(wake - now) <= (int32_t)margin)
+          wake = now + margin; //too close (or past): wake up as soon as possible, & wait in the ISR
+        while (!arm(wake))
+        {
+          margin *= 2;
+          wake = COUNTER::get_count_in_isr() + margin;
+        }
+        _next_timer = i;
+      }
+      return ((handle_t)_generation[i] << 8) | i;
+    }
+
+    inline void link(uint8_t i, uint8_t slot)
+    {
+      _slot[i] = slot;
+      _prev[i] = NONE;
+      _next[i] = _head[slot];
+      if (_head[slot] != NONE)
+        _prev[_head[slot]] = i;
+      _head[slot] = i;
+    }
+
+    inline void unlink(uint8_t i)
+    {
+      if (_prev[i] != NONE)
+        _next[_prev[i]] = _next[i];
+      else
+        _head[_slot[i]] = _next[i];
+      if (_next[i] != NONE)
+        _prev[_next[i]] = _prev[i];
+    }
+
+    inline void release(uint8_t i)
+    {
+      _slot[i] = NONE;
+      _generation[i]++; //invalidates every handle to this timer
+      _next[i] = _free;
+      _free = i;
+      _pending--;
+    }
+
+    //set the compare match to wake up at count "wake", normally at least MIN_ARM_COUNTS away; interrupts must be off.  Returns
+    //false if the count got to "wake" before the compare register was set, ie: the match was missed (& would next happen 1 whole
+    //overflow period late).
+    //OCFnx is set as TCNTn counts from OCRnx to OCRnx + 1, so OCRnx = wake - 1.  The flag is cleared BEFORE OCRnx is written, so
+    //the worst a match on the old OCRnx can do is one early (harmless) wake-up.
+    inline bool arm(uint32_t wake)
+    {
+      Compare::clear_flag();
+      Compare::ocr() = (count_t)(wake - 1);
+      _wake_count = wake;
+      Compare::interrupt_on();
+      return (int32_t)(wake - COUNTER::get_count_in_isr()) > 0 || Compare::flag_is_set();
+    }
+
+    //wait, with interrupts off, until the count reaches "target" (which must be < 2^31 counts away); returns at once if it
+    //already has.  The last stretch checks only the low byte of TCNT, so the wait ends within a few CPU cycles of the target.
+    static inline void wait_until(uint32_t target)
+    {
+      int32_t remaining;
+      while ((remaining = (int32_t)(target - COUNTER::get_count_in_isr())) > 64) {}
+      if (remaining <= 0)
+        return;
+      uint8_t target_low = (uint8_t)target;
+      while ((int8_t)((uint8_t)Regs::tcnt() - target_low) < 0) {}
+    }
+
+    inline void fire(uint8_t i)
+    {
+      callback_t callback = _callback[i];
+      void* arg = _arg[i];
+      unlink(i);
+      release(i); //before the call, so the callback may re-use this timer
+      callback(arg);
+    }
+
+    //run every timer due at count "now": look through the slots of each overflow period from where the last look ended up to
+    //now's period (at most NUM_SLOTS of them: by then every slot has been looked through)
+    void fire_due(uint32_t now)
+    {
+      uint32_t count = _scan_count;
+      uint32_t now_start = period_start(now);
+      _scan_count = now_start; //set first, so a callback that schedules an already-due timer puts it in a slot still to be looked at
+      for (uint8_t n = 0; n < NUM_SLOTS; n++)
+      {
+        uint8_t slot = slot_of(count);
+        uint8_t i = _head[slot];
+        while (i != NONE)
+        {
+          if ((int32_t)(_deadline[i] - now) <= 0)
+          {
+            fire(i);
+            i = _head[slot]; //the callback may have changed this slot's list; start over
+          }
+          else
+            i = _next[i];
+        }
+        if (count == now_start)
+          break;
+        count += COUNTS_PER_PERIOD;
+      }
+    }
+
+    //find the timer with the earliest deadline within the next NUM_SLOTS periods (from where fire_due() ended up); NONE if there
+    //isn't one.  The slots are looked at in time order, so the first one holding a timer for its period this round wins.
+    uint8_t find_next() const
+    {
+      uint32_t count = _scan_count;
+      for (uint8_t n = 0; n < NUM_SLOTS; n++)
+      {
+        uint32_t period_end = count + COUNTS_PER_PERIOD;
+        uint8_t earliest = NONE;
+        for (uint8_t i = _head[slot_of(count)]; i != NONE; i = _next[i])
+        {
+          if ((int32_t)(_deadline[i] - period_end) < 0 &&
+              (earliest == NONE || (int32_t)(_deadline[i] - _deadline[earliest]) < 0))
+            earliest = i;
+        }
+        if (earliest != NONE)
+          return earliest;
+        count = period_end;
+      }
+      return NONE;
+    }
+
+    //run everything due, then set up the next wake-up; interrupts must be off
+    void service(uint32_t now)
+    {
+      _in_service = true;
+      for (;;)
+      {
+        //the timer this wake-up was set for: wait for its exact count, & run it first, with the least delay
+        if (_next_timer != NONE)
+        {
+          uint8_t i = _next_timer;
+          _next_timer = NONE;
+          wait_until(_deadline[i]);
+          fire(i);
+          now = COUNTER::get_count_in_isr();
+        }
+        fire_due(now);
+
+        if (_pending == 0)
+        {
+          Compare::interrupt_off();
+          break;
+        }
+        uint8_t i = find_next();
+        //if every pending timer is more than NUM_SLOTS periods away, wake up again 1 period before the wheel could hold one
+        uint32_t wake = i != NONE ? _deadline[i] - LEAD_COUNTS : _scan_count + (NUM_SLOTS - 1)*COUNTS_PER_PERIOD;
+        now = COUNTER::get_count_in_isr();
+        if ((int32_t)(wake - now) > (int32_t)MIN_ARM_COUNTS && arm(wake))
+        {
+          _next_timer = i;
+          break;
+        }
+        //too close to set the compare match for; handle it right here instead
+        if (i != NONE)
+          _next_timer = i;
+        else
+        {
+          wait_until(wake);
+          now = COUNTER::get_count_in_isr();
+        }
+      }
+      _in_service = false;
+    }
+
+    uint32_t _deadline[CAPACITY]; //counts
+    callback_t _callback[CAPACITY];
+    void* _arg[CAPACITY];
+    uint8_t _next[CAPACITY]; //the next timer in the same slot (or in the free list)
+    uint8_t _prev[CAPACITY];
+    uint8_t _slot[CAPACITY]; //NONE if the timer is free
+    uint8_t _generation[CAPACITY];
+    uint8_t _head[NUM_SLOTS]; //the first timer in each slot
+    uint8_t _free; //the first free timer
+    uint8_t _pending;
+    uint8_t _next_timer; //the timer the compare match is set for; NONE for a wake-up just to look at the wheel again
+    bool _in_service;
+    uint32_t _wake_count; //the count the compare match is set for
+    uint32_t _scan_count; //the start of the last overflow period fire_due() looked through
+};
+
+#endif
@@ -0,0 +1,158 @@
+/*
+eRCaGuy_TimestampRingBuffer
+-a lock-free, single-producer/single-consumer (SPSC) ring buffer of (timestamp, pin state) records, for passing edge times from an
+ ISR (the producer) to loop() (the consumer) without losing any when loop() is busy, ex: in Serial.print()
+-the ISR side, push(), never touches SREG, never disables interrupts, & takes the same small, bounded number of cycles every time
+ (no loops).  If the buffer is full the new record is dropped & counted, rather than overwriting older, unread records.
+-the loop() side, pop(), copies out as many records as are waiting (up to the size of your array), in one batch.
+-the capacity & the timestamp width are template parameters, so RAM use is exact & known at compile time (on the AVR, which never pads structs):
+   CAPACITY*(sizeof(TIMESTAMP_T) + 1) + 4 bytes
+ ex: TimestampRingBuffer<32> uses 32*(4+1) + 4 = 164 bytes; TimestampRingBuffer<32,uint16_t> uses 32*(2+1) + 4 = 100 bytes.
+
+Basic usage:
+  TimestampRingBuffer<32> edges; //32 records of (unsigned long timestamp, byte pin state)
+
+  ISR(...) { edges.push(timer2.get_count_in_isr(), pinState); }
+
+  void loop()
+  {
+    TimestampRingBuffer<32>::Record records[8];
+    uint8_t n = edges.pop(records, 8);
+    for (uint8_t i = 0; i < n; i++) { ...records[i].timestamp, records[i].pin_state... }
+  }
+
+How it works:
+-_head is written ONLY by the producer & _tail ONLY by the consumer.  Both are single bytes, so each is read & written atomically
+ on the AVR without disabling interrupts.  They count up freely (wrapping at 256) & are masked to index the array, so
+ _head - _tail is always the number of records waiting, from 0 to CAPACITY; that is why CAPACITY must be a power of 2 <= 128.
+-a record is fully written before _head is advanced past it, & fully read before _tail is advanced past it; the compiler barriers
+ below keep the compiler from reordering those accesses.  The AVR itself never reorders memory accesses.
+-uint16_t timestamps (the low 16 bits of get_count()) are enough when the time between edges is always < 65536 counts
+ (32.768ms @ 0.5us/count), since differences of unsigned values are correct across a rollover; otherwise use uint32_t.
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#ifndef eRCaGuy_TimestampRingBuffer_h
+#define eRCaGuy_TimestampRingBuffer_h
+
+#include <stdint.h>
+
+//keeps the compiler from moving memory accesses across this point; it generates no code
+#define TIMESTAMP_RING_BUFFER_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+
+template <uint8_t CAPACITY, typename TIMESTAMP_T = uint32_t>
+class TimestampRingBuffer
+{
+  static_assert(CAPACITY >= 2 && CAPACITY <= 128 && (CAPACITY & (CAPACITY - 1)) == 0,
+                "TimestampRingBuffer: CAPACITY must be a power of 2, from 2 to 128");
+
+  public:
+    struct Record
+    {
+      TIMESTAMP_T timestamp; //ex: from timer2.get_count()
+      uint8_t pin_state; //the pin (or whole port) state at that time; any byte you like
+    };
+
+    TimestampRingBuffer() : _head(0), _tail(0), _overrun_count(0) {}
+
+    //---------------------------------------------------------------------------------------------------
+    //Producer (ISR) side; call from ONE place only, ex: one ISR, or several ISRs which can't interrupt each other
+    //---------------------------------------------------------------------------------------------------
+
+    //add a record; returns false (& counts an overrun) if the buffer is full
+    inline bool push(TIMESTAMP_T timestamp, uint8_t pin_state)
+    {
+      uint8_t head = _head;
+      if ((uint8_t)(head - _tail) >= CAPACITY) //full
+      {
+        uint16_t overrun_count = _overrun_count;
+        if (overrun_count != 0xFFFF) //saturate rather than roll over to 0
+          _overrun_count = overrun_count + 1;
+        return false;
+      }
+      Record& record = _records[head & MASK];
+      record.timestamp = timestamp;
+      record.pin_state = pin_state;
+      TIMESTAMP_RING_BUFFER_BARRIER(); //the record must be written BEFORE it is published to the consumer
+      _head = head + 1;
+      return true;
+    }
+
+    //---------------------------------------------------------------------------------------------------
+    //Consumer (loop()) side
+    //---------------------------------------------------------------------------------------------------
+
+    //copy up to max_records records, oldest first, into records[], & free their slots; returns the # copied
+    uint8_t pop(Record* records, uint8_t max_records)
+    {
+      uint8_t tail = _tail;
+      uint8_t num_records = _head - tail;
+      TIMESTAMP_RING_BUFFER_BARRIER(); //don't read any record before reading _head
+      if (num_records > max_records)
+        num_records = max_records;
+      for (uint8_t i = 0; i < num_records; i++)
+        records[i] = _records[(uint8_t)(tail + i) & MASK];
+      TIMESTAMP_RING_BUFFER_BARRIER(); //finish reading the records BEFORE giving their slots back to the producer
+      _tail = tail + num_records;
+      return num_records;
+    }
+
+    //copy out the single oldest record; returns false if the buffer is empty
+    inline bool pop(Record& record)
+    {
+      return pop(&record, 1) == 1;
+    }
+
+    //# of records waiting to be popped
+    inline uint8_t available() const
+    {
+      return _head - _tail;
+    }
+
+    //total # of records dropped because the buffer was full (saturates at 65535).  Use it to size CAPACITY: if it ever increases,
+    //loop() isn't keeping up, so either drain more often or make the buffer bigger.
+    //-it's 2 bytes, so it can't be read atomically while the producer may change it; instead, read it until 2 reads agree.
+    uint16_t get_overrun_count() const
+    {
+      uint16_t overrun_count;
+      do
+      {
+        overrun_count = _overrun_count;
+      } while (overrun_count != _overrun_count);
+      return overrun_count;
+    }
+
+  private:
+    static const uint8_t MASK = CAPACITY - 1;
+    Record _records[CAPACITY];
+    volatile uint8_t _head; //written only by push()
+    volatile uint8_t _tail; //written only by pop()
+    volatile uint16_t _overrun_count; //written only by push()
+};
+
+#endif
@@ -0,0 +1,260 @@
+/*
+eRCaGuy_TimestampStream
+-a compact binary format for streaming timestamps (or durations, or any other uint32_t values) out of the serial port, so that
+ EVERY edge can be logged, instead of printing a sampled subset with several Serial.print() calls each
+-values are batched into frames; within a frame each value after the first is sent as the difference from the previous one, as a
+ zigzag varint (see below), so a typical edge timestamp (@ 0.5us/count) takes 2~3 bytes on the wire, vs. ~15~25 bytes as ASCII text
+-writing never blocks: service() writes only as many bytes as the serial port's transmit buffer has room for right now, & when
+ the encoder's own transmit queue is full, whole frames are dropped & counted rather than stalling loop().  Each frame has a
+ sequence # & a checksum, so the host sees exactly which frames were dropped or corrupted.
+-a host (PC) decoder is in extras/timestamp_stream_decoder/
+
+Frame format (all multi-byte values are sent in the order shown):
+  byte 0     SYNC_0 (0xA5)
+  byte 1     SYNC_1 (0x5A)
+  byte 2     LEN: # of payload bytes (1 to 250)
+  byte 3     SEQ: frame sequence #, 0 to 255, then rolls over; a gap in SEQ means frames were lost
+  byte 4     COUNT: # of values in the payload, or 0 for a tagged value frame (see below)
+  LEN bytes  payload: the 1st value as an unsigned varint, then COUNT-1 zigzag varint deltas
+  2 bytes    Fletcher-16 checksum of bytes 2 through the end of the payload: sum1, then sum2 (each mod 255)
+-the 1st value in each frame is absolute, so every frame decodes on its own, even after lost frames.
+-SEQ is only 8 bits, so the host can only count a gap mod 256: a burst of 256 or more lost frames in a row is reported as 0 to 255.
+-a tagged value frame (COUNT = 0) carries one value which isn't part of the data, ex: a status counter, so it needn't be squeezed
+ into the data values.  Its payload is TAG (1 byte), then the value as an unsigned varint.  TAG_OVERRUN_COUNT (1) is the running
+ total of values lost before they reached the encoder, ex: TimestampRingBuffer::get_overrun_count(), which the host decoder
+ reports; any other tag is yours to define (the decoder just prints it).
+-varint (as in Protocol Buffers/LEB128): 7 bits per byte, least significant group first; the top bit of each byte is 1 if more
+ bytes follow.  Values < 128 take 1 byte, < 16384 2 bytes, < 2097152 3 bytes, ... up to 5 bytes.
+-zigzag: a signed delta d is sent as the unsigned (d << 1) ^ (d >> 31), ie: 0, -1, 1, -2, 2 ... --> 0, 1, 2, 3, 4 ..., so small
+ negative deltas (ex: pulse widths which got slightly shorter) are small too.  Deltas are taken mod 2^32, so a get_count() rollover
+ costs nothing.
+
+Basic usage:
+  #include <eRCaGuy_TimestampStream.h>
+
+  TimestampStreamEncoder<> stream;
+
+  void loop()
+  {
+    ...for each new timestamp t: stream.add(t);
+    stream.service(Serial); //call often; never blocks
+  }
+
+Frames are closed when they are full, when you call end_frame(), or by service() as soon as the transmit queue has emptied, so at
+low data rates each value goes out right away (in a small frame), & at high data rates frames fill up & the overhead per value
+drops.  Call add(), add_tagged(), end_frame(), & service() from loop() only (not from an ISR); use a TimestampRingBuffer to get the timestamps out
+of the ISR.
+
+RAM used: MAX_PAYLOAD + TX_BUFFER_SIZE + 11 bytes; ex: TimestampStreamEncoder<> uses 48 + 128 + 11 = 187 bytes.
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#ifndef eRCaGuy_TimestampStream_h
+#define eRCaGuy_TimestampStream_h
+
+#include <stdint.h>
+
+//---------------------------------------------------------------------------------------------------
+//The wire format; shared by the encoder below & by the host decoder
+//---------------------------------------------------------------------------------------------------
+struct TimestampStreamFormat
+{
+  static const uint8_t SYNC_0 = 0xA5;
+  static const uint8_t SYNC_1 = 0x5A;
+  static const uint8_t HEADER_SIZE = 5; //SYNC_0, SYNC_1, LEN, SEQ, COUNT
+  static const uint8_t CHECKSUM_SIZE = 2;
+  static const uint8_t MAX_PAYLOAD = 250;
+  static const uint8_t MAX_VARINT_SIZE = 5; //for a uint32_t
+  static const uint8_t TAG_OVERRUN_COUNT = 1; //tagged value: running total of values lost before they reached the encoder
+
+  static inline uint32_t zigzag_encode(int32_t delta) { return ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31); }
+  static inline int32_t zigzag_decode(uint32_t value) { return (int32_t)(value >> 1) ^ -(int32_t)(value & 1); }
+
+  //write value into buf as a varint; returns the # of bytes written (1 to 5)
+  static inline uint8_t varint_encode(uint32_t value, uint8_t* buf)
+  {
+    uint8_t len = 0;
+    while (value >= 0x80)
+    {
+      buf[len++] = (uint8_t)value | 0x80;
+      value >>= 7;
+    }
+    buf[len++] = (uint8_t)value;
+    return len;
+  }
+
+  //add bytes to a running Fletcher-16 checksum; start with sum1 = sum2 = 0
+  static inline void fletcher16_update(uint8_t& sum1, uint8_t& sum2, const uint8_t* bytes, uint8_t len)
+  {
+    uint16_t s1 = sum1;
+    uint16_t s2 = sum2;
+    for (uint8_t i = 0; i < len; i++)
+    {
+      s1 += bytes[i];
+      if (s1 >= 255) s1 -= 255;
+      s2 += s1;
+      if (s2 >= 255) s2 -= 255;
+    }
+    sum1 = s1;
+    sum2 = s2;
+  }
+};
+
+//---------------------------------------------------------------------------------------------------
+//The encoder
+//-MAX_PAYLOAD: the largest frame payload, in bytes: 5 to TX_BUFFER_SIZE - 7, so at most 121 (the format itself allows up to 250,
+// but a whole frame must fit in the transmit queue); bigger frames = less overhead per value, but a longer wait before a busy
+// stream's values go out
+//-TX_BUFFER_SIZE: the encoder's transmit queue, in bytes; a power of 2 from 16 to 128, & at least MAX_PAYLOAD + 7 (one whole frame)
+//---------------------------------------------------------------------------------------------------
+template <uint8_t MAX_PAYLOAD = 48, uint8_t TX_BUFFER_SIZE = 128>
+class TimestampStreamEncoder
+{
+  static_assert(MAX_PAYLOAD >= TimestampStreamFormat::MAX_VARINT_SIZE && MAX_PAYLOAD <= TimestampStreamFormat::MAX_PAYLOAD,
+                "TimestampStreamEncoder: MAX_PAYLOAD must be at least 5 (one whole varint)");
+  static_assert(TX_BUFFER_SIZE >= 16 && TX_BUFFER_SIZE <= 128 && (TX_BUFFER_SIZE & (TX_BUFFER_SIZE - 1)) == 0,
+                "TimestampStreamEncoder: TX_BUFFER_SIZE must be a power of 2, from 16 to 128");
+  static_assert(TX_BUFFER_SIZE >= MAX_PAYLOAD + TimestampStreamFormat::HEADER_SIZE + TimestampStreamFormat::CHECKSUM_SIZE,
+                "TimestampStreamEncoder: TX_BUFFER_SIZE must hold one whole frame, MAX_PAYLOAD + 7 bytes, so MAX_PAYLOAD can be at "
+                "most TX_BUFFER_SIZE - 7 (121 with the largest TX_BUFFER_SIZE, 128)");
+
+  public:
+    TimestampStreamEncoder() : _payload_len(0), _value_count(0), _value_old(0), _seq(0), _tx_head(0), _tx_tail(0),
+                               _dropped_frame_count(0) {}
+
+    //add one value to the current frame; if it doesn't fit, the current frame is closed first
+    void add(uint32_t value)
+    {
+      uint8_t varint[TimestampStreamFormat::MAX_VARINT_SIZE];
+      uint8_t len;
+      if (_value_count != 0)
+      {
+        len = TimestampStreamFormat::varint_encode(TimestampStreamFormat::zigzag_encode((int32_t)(value - _value_old)), varint);
+        if (_payload_len + len > MAX_PAYLOAD || _value_count == 0xFF)
+        {
+          end_frame();
+          len = TimestampStreamFormat::varint_encode(value, varint); //the 1st value of a frame is absolute
+        }
+      }
+      else
+        len = TimestampStreamFormat::varint_encode(value, varint);
+      for (uint8_t i = 0; i < len; i++)
+        _payload[_payload_len + i] = varint[i];
+      _payload_len += len;
+      _value_count++;
+      _value_old = value;
+    }
+
+    //close the current frame (if it has any values) & queue it for sending; if the transmit queue has no room for it, it is
+    //dropped & counted instead.  Either way it uses up a sequence #, so the host sees the gap.
+    void end_frame()
+    {
+      if (_value_count == 0)
+        return;
+      queue_frame(_value_count, _payload, _payload_len);
+      _payload_len = 0;
+      _value_count = 0;
+    }
+
+    //send "value" in a tagged value frame of its own (see the format above), ex: every second or so,
+    //add_tagged(TimestampStreamFormat::TAG_OVERRUN_COUNT, edges.get_overrun_count()).  The current frame is closed first.  Like
+    //any frame it is dropped (& counted) if the transmit queue has no room, so send running totals, & resend them periodically.
+    void add_tagged(uint8_t tag, uint32_t value)
+    {
+      end_frame();
+      uint8_t payload[1 + TimestampStreamFormat::MAX_VARINT_SIZE];
+      payload[0] = tag;
+      queue_frame(0, payload, 1 + TimestampStreamFormat::varint_encode(value, payload + 1));
+    }
+
+    //write as many queued bytes to port (ex: Serial) as it can take without blocking; call often, ex: every loop().  If
+    //everything queued has been sent, the current frame is closed & sent too, so values never wait long at low data rates.
+    //-port must have availableForWrite() (HardwareSerial does, since Arduino 1.6.x)
+    template <typename PORT>
+    void service(PORT& port)
+    {
+      if (tx_queued() == 0)
+        end_frame();
+      int room = port.availableForWrite();
+      while (room > 0 && _tx_tail != _tx_head)
+      {
+        port.write(_tx_buffer[_tx_tail & TX_MASK]);
+        _tx_tail++;
+        room--;
+      }
+    }
+
+    //total # of frames dropped because the transmit queue was full (saturates at 65535)
+    inline uint16_t get_dropped_frame_count() const { return _dropped_frame_count; }
+
+    //# of bytes waiting in the transmit queue
+    inline uint8_t tx_queued() const { return _tx_head - _tx_tail; }
+
+  private:
+    static const uint8_t TX_MASK = TX_BUFFER_SIZE - 1;
+
+    //queue one whole frame, or drop & count it if the transmit queue has no room; either way it uses up a sequence #
+    void queue_frame(uint8_t count, const uint8_t* payload, uint8_t payload_len)
+    {
+      uint8_t header[TimestampStreamFormat::HEADER_SIZE] =
+        {TimestampStreamFormat::SYNC_0, TimestampStreamFormat::SYNC_1, payload_len, _seq, count};
+      uint8_t frame_len = TimestampStreamFormat::HEADER_SIZE + payload_len + TimestampStreamFormat::CHECKSUM_SIZE;
+      if (frame_len <= TX_BUFFER_SIZE - tx_queued())
+      {
+        uint8_t sum1 = 0, sum2 = 0;
+        TimestampStreamFormat::fletcher16_update(sum1, sum2, header + 2, TimestampStreamFormat::HEADER_SIZE - 2);
+        TimestampStreamFormat::fletcher16_update(sum1, sum2, payload, payload_len);
+        tx_put(header, TimestampStreamFormat::HEADER_SIZE);
+        tx_put(payload, payload_len);
+        tx_put(&sum1, 1);
+        tx_put(&sum2, 1);
+      }
+      else if (_dropped_frame_count != 0xFFFF) //saturate rather than roll over to 0
+        _dropped_frame_count++;
+      _seq++;
+    }
+
+    inline void tx_put(const uint8_t* bytes, uint8_t len)
+    {
+      for (uint8_t i = 0; i < len; i++)
+        _tx_buffer[(uint8_t)(_tx_head + i) & TX_MASK] = bytes[i];
+      _tx_head += len;
+    }
+
+    uint8_t _payload[MAX_PAYLOAD]; //the frame being built
+    uint8_t _payload_len;
+    uint8_t _value_count;
+    uint32_t _value_old; //the last value added, for the next delta
+    uint8_t _seq;
+    uint8_t _tx_buffer[TX_BUFFER_SIZE];
+    uint8_t _tx_head; //free-running, like TimestampRingBuffer's; masked to index _tx_buffer
+    uint8_t _tx_tail;
+    uint16_t _dropped_frame_count;
+};
+
+#endif
@@ -0,0 +1,220 @@
+/*
+benchmark_cycles.ino
+-measures, in CPU clock cycles, how long the various Timer2_Counter functions take to execute, on the actual Arduino
+-it uses the 16-bit Timer1, running with no prescaler, as a cycle counter: TCNT1 is read just before & just after the code under
+ test, with interrupts off, & the cost of the measurement itself (measured with nothing in between) is subtracted.
+-it also compares float time conversions (get_micros(), 1000000.0/period) with the integer ones in 
+ eRCaGuy_TimerCounter_Durations.h (Ticks::to_micros(), frequency_hz(), etc.)
+-for comparison, it includes an exact copy of the ORIGINAL (version 1.0) get_count(), which computed
+ "_overflow_count*256 + tcnt2_save" & stored it into a member variable, & was an out-of-line (non-inline) call.
+-it also measures the Timer2 overflow ISR itself, from the interrupt being taken to "reti", by making an overflow pending with
+ interrupts off, then letting the ISR run between 2 reads of TCNT1.  Which ISR that is (the assembly one or the C++ one) depends on
+ TIMER_COUNTER_FAST_OVF_ISR when the library was compiled; see eRCaGuy_TimerCounter.h.  To compare the two, run this sketch once
+ with each.
+
+Written: 16 Oct. 2026
+
+NOTES:
+-this sketch takes over Timer1, so PWM on pins 9 & 10, & the Servo library, won't work while it runs.
+-each result is printed as min/max over many runs; min & max differ only when the rare "overflow pending" branch is taken.
+-run this on an ATmega328-based board (Uno, Nano, Pro Mini, etc).  To run the same code under simavr instead, build it with the
+ Arduino IDE ("Sketch --> Export compiled Binary"), & load the .elf into simavr with the serial port (UART0) traced.
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#include <eRCaGuy_Timer2_Counter.h>
+#include <eRCaGuy_TimerCounter_Durations.h>
+
+const unsigned int NUM_RUNS = 1000; //# of times to measure each function
+
+//---------------------------------------------------------------------------------------------------
+//The original (version 1.0) implementation, copied verbatim, for comparison only.
+//NB: it clears the same Timer2 overflow flag the library uses, so it can "steal" an overflow count from the library's timer2
+//object while the benchmark runs; that doesn't matter here.
+//---------------------------------------------------------------------------------------------------
+class Legacy_Timer2_Counter
+{
+  public:
+    Legacy_Timer2_Counter() : _overflow_count(0), _total_count(0) {}
+    unsigned long get_count() __attribute__((noinline)); //it was defined in the .cpp file, so it was never inlined
+  private:
+    volatile unsigned long _overflow_count;
+    unsigned long _total_count;
+};
+
+unsigned long Legacy_Timer2_Counter::get_count()
+{
+  uint8_t SREG_old = SREG;
+  noInterrupts();
+  uint8_t tcnt2_save = TCNT2;
+  boolean flag_save = bitRead(TIFR2,0);
+  if (flag_save) {
+    tcnt2_save = TCNT2;
+    _overflow_count++;
+    TIFR2 |= 0b00000001;
+  }
+  _total_count = _overflow_count*256 + tcnt2_save;
+  SREG = SREG_old;
+  return _total_count;
+}
+
+Legacy_Timer2_Counter legacy_timer2;
+
+//---------------------------------------------------------------------------------------------------
+//Cycle measurement
+//---------------------------------------------------------------------------------------------------
+volatile unsigned long sink32; //results are written here so the compiler can't optimize the code under test away
+volatile unsigned long long sink64;
+volatile float sink_float;
+volatile unsigned long source32 = 40001; //a period, in counts; volatile so the conversions below can't be done at compile time
+unsigned int measurement_overhead = 0; //cycles; the cost of MEASURE_CYCLES() itself
+
+//Run "code" NUM_RUNS times, with interrupts off, & record the min & max number of CPU cycles it took.
+#define MEASURE_CYCLES(code, min_cycles, max_cycles) \
+  do { \
+    min_cycles = 0xFFFF; \
+    max_cycles = 0; \
+    for (unsigned int i = 0; i < NUM_RUNS; i++) \
+    { \
+      uint8_t SREG_old = SREG; \
+      noInterrupts(); \
+      uint16_t t_start = TCNT1; \
+      code; \
+      uint16_t t_end = TCNT1; \
+      SREG = SREG_old; \
+      uint16_t cycles = t_end - t_start - measurement_overhead; \
+      if (cycles < min_cycles) min_cycles = cycles; \
+      if (cycles > max_cycles) max_cycles = cycles; \
+    } \
+  } while (0)
+
+//Run the Timer2 overflow ISR once, if overflow_pending, & return the # of CPU cycles from just before interrupts are enabled to 
+//just after they are disabled again; the difference between this with & without an overflow pending is the ISR's total cost.
+//NB: it writes TCNT2, so it disturbs timer2's count; that doesn't matter here.
+uint16_t runOverflowIsr(bool overflow_pending)
+{
+  uint8_t SREG_old = SREG;
+  noInterrupts();
+  uint8_t TIMSK0_old = TIMSK0;
+  TIMSK0 = 0; //keep the millis() ISR out of the measurement
+  TIFR2 = _BV(TOV2);
+  if (overflow_pending)
+  {
+    TCNT2 = 0xFF;
+    while (!(TIFR2 & _BV(TOV2))) {} //wait for the overflow: at most 8 cycles @ prescaler 8
+  }
+  else
+    TCNT2 = 0; //the next overflow is 2048 cycles away
+  uint16_t t_start = TCNT1;
+  interrupts();
+  __asm__ __volatile__("nop"); //the AVR always executes 1 more instruction after "sei" before taking a pending interrupt
+  noInterrupts();
+  uint16_t t_end = TCNT1;
+  TIMSK0 = TIMSK0_old;
+  SREG = SREG_old;
+  return t_end - t_start;
+}
+
+void printResult(const __FlashStringHelper* name, uint16_t min_cycles, uint16_t max_cycles)
+{
+  Serial.print(name);
+  Serial.print(F(": min = ")); Serial.print(min_cycles);
+  Serial.print(F(", max = ")); Serial.print(max_cycles);
+  Serial.print(F(" cycles (")); Serial.print(min_cycles*1000000.0/F_CPU, 4);
+  Serial.println(F(" us min)"));
+}
+
+void setup()
+{
+  timer2.setup();
+
+  //Timer1: normal mode, no prescaler --> TCNT1 counts CPU cycles; see datasheet pg. 132-137
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);
+  TIMSK1 = 0;
+
+  Serial.begin(115200);
+  Serial.println(F("CPU cycles per call, measured with Timer1 (1 count = 1 CPU cycle):"));
+
+  uint16_t min_cycles, max_cycles;
+
+  //first, measure the measurement overhead, with nothing under test
+  MEASURE_CYCLES(sink32 = 0, min_cycles, max_cycles);
+  measurement_overhead = min_cycles;
+  Serial.print(F("(measurement overhead subtracted from all results below: ")); Serial.print(measurement_overhead);
+  Serial.println(F(" cycles)"));
+
+  MEASURE_CYCLES(sink32 = legacy_timer2.get_count(), min_cycles, max_cycles);
+  printResult(F("original v1.0 get_count()      "), min_cycles, max_cycles);
+  MEASURE_CYCLES(sink32 = timer2.get_count(), min_cycles, max_cycles);
+  printResult(F("timer2.get_count()             "), min_cycles, max_cycles);
+  MEASURE_CYCLES(sink32 = timer2.get_count_in_isr(), min_cycles, max_cycles);
+  printResult(F("timer2.get_count_in_isr()      "), min_cycles, max_cycles);
+  MEASURE_CYCLES(sink64 = timer2.get_count64(), min_cycles, max_cycles);
+  printResult(F("timer2.get_count64()           "), min_cycles, max_cycles);
+  MEASURE_CYCLES(sink_float = timer2.get_micros(), min_cycles, max_cycles);
+  printResult(F("timer2.get_micros()            "), min_cycles, max_cycles);
+  MEASURE_CYCLES(sink32 = micros(), min_cycles, max_cycles);
+  printResult(F("Arduino micros(), for reference"), min_cycles, max_cycles);
+
+  Serial.flush(); //don't let the Serial TX ISR skew the measurement
+  uint16_t cycles_without_isr = 0xFFFF, cycles_with_isr = 0xFFFF;
+  for (unsigned int i = 0; i < NUM_RUNS; i++)
+  {
+    uint16_t cycles = runOverflowIsr(false);
+    if (cycles < cycles_without_isr) cycles_without_isr = cycles;
+    cycles = runOverflowIsr(true);
+    if (cycles < cycles_with_isr) cycles_with_isr = cycles;
+  }
+  uint16_t isr_cycles = cycles_with_isr - cycles_without_isr;
+  Serial.print(TIMER_COUNTER_FAST_OVF_ISR ? F("Timer2 overflow ISR (assembly): ") : F("Timer2 overflow ISR (C++): "));
+  Serial.print(isr_cycles); Serial.print(F(" cycles (")); Serial.print(isr_cycles*1000000.0/F_CPU, 4);
+  Serial.print(F(" us); TIMER_COUNTER_OVF_ISR_CYCLES = ")); Serial.print(TIMER_COUNTER_OVF_ISR_CYCLES);
+  Serial.print(F("; CPU load @ 1 ISR per 128us = ")); Serial.print(isr_cycles*100.0/2048, 3); Serial.println(F("%"));
+
+  Serial.println(F("Time conversions, float vs. integer (eRCaGuy_TimerCounter_Durations.h):"));
+  MEASURE_CYCLES(sink_float = source32/2.0, min_cycles, max_cycles);
+  printResult(F("count/2.0 (float us)           "), min_cycles, max_cycles);
+  MEASURE_CYCLES(sink32 = Ticks(source32).to_micros().value, min_cycles, max_cycles);
+  printResult(F("Ticks::to_micros()             "), min_cycles, max_cycles);
+  MEASURE_CYCLES(sink32 = Ticks(source32).to_nanos().value, min_cycles, max_cycles);
+  printResult(F("Ticks::to_nanos()              "), min_cycles, max_cycles);
+  MEASURE_CYCLES(sink_float = 1000000.0/(source32/2.0), min_cycles, max_cycles);
+  printResult(F("1000000.0/(count/2.0) (float Hz)"), min_cycles, max_cycles);
+  MEASURE_CYCLES(sink32 = Ticks(source32).frequency_hz(), min_cycles, max_cycles);
+  printResult(F("Ticks::frequency_hz()          "), min_cycles, max_cycles);
+  MEASURE_CYCLES(sink32 = Ticks(source32).frequency_millihz(), min_cycles, max_cycles);
+  printResult(F("Ticks::frequency_millihz()     "), min_cycles, max_cycles);
+
+  Serial.println(F("Done."));
+}
+
+void loop()
+{
+  //nothing to do
+}
@@ -0,0 +1,106 @@
+/*
+choose_prescaler.ino
+-helps you choose the cheapest timer & prescaler that still gives the time resolution you need
+-part 1 prints, for every Timer2 & Timer1 prescaler, the resolution, overflow period, overflow ISR calls/sec, & estimated CPU
+ load of the overflow ISR.  All of these are compile-time constants of TimerCounter<TIMER_ID,PRESCALER>; see eRCaGuy_TimerCounter.h.
+-part 2 MEASURES the actual CPU load of the Timer2 overflow ISR, at each Timer2 prescaler, by counting how many times a busy loop
+ runs in 200ms with the overflow interrupt on vs. off.  (Timer0's millis() ISR runs in both cases, so it cancels out.)  Run it
+ with TIMER_COUNTER_FAST_OVF_ISR set to 1 & then 0 (see eRCaGuy_TimerCounter.h) to compare the assembly & C++ overflow ISRs.
+
+Written: 16 Oct. 2026
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#include <eRCaGuy_Timer2_Counter.h>
+
+const unsigned long MEASUREMENT_TIME_MS = 200;
+
+//busy-loop for MEASUREMENT_TIME_MS & return how many times the loop ran
+unsigned long countLoops()
+{
+  unsigned long num_loops = 0;
+  unsigned long t_start = millis();
+  while (millis() - t_start < MEASUREMENT_TIME_MS)
+    num_loops++;
+  return num_loops;
+}
+
+//print the compile-time numbers for one timer & prescaler, then, for Timer2 only, measure its overflow ISR's actual load
+template <uint8_t TIMER_ID, uint16_t PRESCALER>
+void report()
+{
+  typedef TimerCounter<TIMER_ID,PRESCALER> Counter;
+  Counter::print_config(Serial);
+  if (TIMER_ID != 2)
+    return;
+  
+  Serial.flush(); //don't let the Serial TX ISR skew the measurement
+  Counter::setup();
+  Counter::overflow_interrupt_off();
+  unsigned long loops_without_isr = countLoops();
+  Counter::overflow_interrupt_on();
+  unsigned long loops_with_isr = countLoops();
+  Counter::revert_to_normal();
+  
+  //load = fraction of loop iterations lost to the ISR, in parts per million; signed, since with a negligible load the 2nd run can
+  //be a few loops faster than the 1st, & that's a load of 0, not a huge unsigned one.  64-bit math, since lost loops*1000000
+  //overflows 32 bits.
+  long loops_lost = (long)loops_without_isr - (long)loops_with_isr;
+  if (loops_lost < 0)
+    loops_lost = 0;
+  unsigned long load_ppm = (unsigned long)((uint64_t)loops_lost*1000000/loops_without_isr);
+  Serial.print(F("  --> measured ISR CPU load = ")); Serial.print(load_ppm);
+  Serial.print(F(" ppm (est. ")); Serial.print(Counter::OVF_ISR_LOAD_PPM); Serial.println(F(" ppm)"));
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.print(F("Overflow ISR: "));
+  Serial.println(TIMER_COUNTER_FAST_OVF_ISR ? F("assembly (TIMER_COUNTER_FAST_OVF_ISR 1)") : F("C++ (TIMER_COUNTER_FAST_OVF_ISR 0)"));
+  Serial.println(F("Timer2 (8-bit); the ISR load below each line is MEASURED:"));
+  report<2,1>();
+  report<2,8>();
+  report<2,32>();
+  report<2,64>();
+  report<2,128>();
+  report<2,256>();
+  report<2,1024>();
+  Serial.println(F("Timer1 (16-bit), estimates only (the Timer1 overflow ISR isn't defined in this sketch):"));
+  report<1,1>();
+  report<1,8>();
+  report<1,64>();
+  report<1,256>();
+  report<1,1024>();
+  Serial.println(F("Done."));
+}
+
+void loop()
+{
+  //nothing to do
+}
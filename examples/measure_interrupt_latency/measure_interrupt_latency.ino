@@ -0,0 +1,99 @@
+/*
+measure_interrupt_latency.ino
+-uses a LatencyProbe (eRCaGuy_LatencyProbe.h) to measure how late an ISR gets to read the time, in 0.5us counts, while the sketch
+ does 3 different things in turn, for 2 seconds each:
+ 1) nothing (only the Arduino core's millis() ISR, & the Timer2 overflow ISR, run)
+ 2) printing lots of text, so the Serial transmit ISR runs constantly
+ 3) turning interrupts off for ~20us at a time, as some libraries do (ex: for bit-banged, timing-critical protocols)
+-then it prints each one's latency statistics (min, mean, percentiles, max, & histogram), so you can see which activity hurts the
+ timing of your own ISRs (ex: pin change ISRs measuring RC pulses) & by how much
+-finally, it sets a correction for the fixed part of the latency, & shows a timestamp with & without it
+
+Written: 16 Oct. 2026
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#include <eRCaGuy_Timer2_Counter.h>
+#include <eRCaGuy_LatencyProbe.h>
+
+enum { SOURCE_IDLE, SOURCE_SERIAL, SOURCE_NO_INTERRUPTS, NUM_SOURCES };
+const char* const SOURCE_NAMES[NUM_SOURCES] = {"idle", "Serial printing", "interrupts off 20us at a time"};
+
+LatencyProbe<NUM_SOURCES> probe; //Timer2 (the "timer2" object's count), compare channel B
+LATENCY_PROBE_ISR(probe, 2, B);
+
+const unsigned long PHASE_TIME_MS = 2000;
+
+//run one activity for PHASE_TIME_MS, probing the latency about once every 200us
+void runPhase(byte source)
+{
+  probe.start(source, 400); //400 counts = 200us
+  unsigned long t_start = millis();
+  while (millis() - t_start < PHASE_TIME_MS)
+  {
+    probe.service();
+    if (source == SOURCE_SERIAL)
+      Serial.println(F("The quick brown fox jumps over the lazy dog."));
+    else if (source == SOURCE_NO_INTERRUPTS)
+    {
+      noInterrupts();
+      delayMicroseconds(20);
+      interrupts();
+      delayMicroseconds(20);
+    }
+  }
+  probe.stop();
+  Serial.flush();
+}
+
+void setup()
+{
+  timer2.setup();
+  Serial.begin(115200);
+  Serial.println(F("begin"));
+  Serial.flush();
+
+  runPhase(SOURCE_IDLE);
+  runPhase(SOURCE_SERIAL);
+  runPhase(SOURCE_NO_INTERRUPTS);
+
+  Serial.println(F("\nInterrupt latency, in counts of 0.5us, for each activity:"));
+  probe.dump(Serial, SOURCE_NAMES);
+
+  //the fixed part of the latency, measured while idle, can be taken off timestamps captured in an ISR
+  probe.set_correction_to_min(SOURCE_IDLE);
+  unsigned long t = timer2.get_count();
+  Serial.print(F("\nCorrection = ")); Serial.print(probe.get_correction(SOURCE_IDLE));
+  Serial.print(F(" counts; ex: timestamp ")); Serial.print(t);
+  Serial.print(F(" --> corrected ")); Serial.println(probe.correct(SOURCE_IDLE, t));
+}
+
+void loop()
+{
+  //nothing to do
+}
@@ -0,0 +1,91 @@
+/*
+profile_sections.ino
+-shows how to find where the time goes in a sketch with eRCaGuy_SectionProfiler.h: a few sections of code (zones) are timed every
+ time they run, & every 2 seconds each zone's count, min, mean, max, & duration histogram are printed.
+-zones can be timed with PROFILE_SCOPE() (from that line to the end of the enclosing { } block), or with a PROFILE_BEGIN()/
+ PROFILE_END() pair; both are shown below.
+
+Written: 16 Oct. 2026
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#include <eRCaGuy_Timer2_Counter.h>
+#include <eRCaGuy_SectionProfiler.h>
+
+//one zone per section of code to time; NUM_ZONES must be last
+enum { ZONE_ANALOG_READ, ZONE_FLOAT_MATH, ZONE_INT_MATH, ZONE_DIGITAL_READ, NUM_ZONES };
+const char* const zone_names[NUM_ZONES] = { "analogRead()", "float math", "integer math", "digitalRead() x8" };
+
+typedef SectionProfiler<NUM_ZONES> Profiler; //uses timer2 (0.5us/count)
+
+volatile float sink_float; //results are written here so the compiler can't optimize the code under test away
+volatile long sink_long;
+
+void setup()
+{
+  timer2.setup();
+  Profiler::calibrate(); //after timer2.setup()
+  Serial.begin(115200);
+  Serial.println(F("Profiling; results every 2 seconds."));
+}
+
+void loop()
+{
+  static unsigned long t_last_dump = millis();
+
+  {
+    PROFILE_SCOPE(Profiler, ZONE_ANALOG_READ);
+    sink_long = analogRead(A0);
+  }
+
+  {
+    PROFILE_SCOPE(Profiler, ZONE_FLOAT_MATH);
+    float x = sink_long;
+    sink_float = sqrt(x)*1.2345 + x/3.0;
+  }
+
+  PROFILE_BEGIN(Profiler, ZONE_INT_MATH);
+  long y = sink_long;
+  sink_long = y*y/7 + y%13;
+  PROFILE_END(Profiler, ZONE_INT_MATH);
+
+  PROFILE_BEGIN(Profiler, ZONE_DIGITAL_READ);
+  byte pins = 0;
+  for (byte pin = 2; pin < 10; pin++)
+    pins = (pins << 1) | digitalRead(pin);
+  sink_long = pins;
+  PROFILE_END(Profiler, ZONE_DIGITAL_READ);
+
+  if (millis() - t_last_dump >= 2000)
+  {
+    t_last_dump += 2000;
+    Profiler::dump(Serial, zone_names); //printing is slow, so it isn't inside any zone
+    Profiler::reset();
+    Serial.println();
+  }
+}
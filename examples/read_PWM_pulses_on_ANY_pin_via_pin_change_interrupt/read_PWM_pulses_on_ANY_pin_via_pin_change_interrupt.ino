@@ -5,6 +5,7 @@ pulse_reader_w_pin_change_interrupt_singleCh.ino
 -I am using some low-level AVR code, which requires using some built-in Arduino macros to do pin-mapping. 
 -this code only reads in a single channel at a time, though it could be expanded to read in signals on every Arduino pin, digital and analog, simultaneously.
 --this would be lots of work, so for now I'll leave that up to you.
+--UPDATE: see the read_RC_receiver_PWM_8_channels & read_RC_receiver_PPM examples, which use eRCaGuy_RCDecoder.h to do just that.
 -this code should be able to read in any pulse between approximately 10~20us and 35.79 minutes; I'll let you experiment
  to find the actual shortest pulse you can measure with it
 
@@ -12,7 +13,8 @@ By Gabriel Staples
 http://www.ElectricRCAircraftGuy.com/
 -My contact info is available by clicking the "Contact Me" tab at the top of my website.
 Written: 28 Nov. 2013
-Updated: 21 March 2015
+Updated: 16 Oct. 2026 - edges are now queued in a TimestampRingBuffer, so none are lost while loop() is busy printing, & all time
+                        math is now integer math, using eRCaGuy_TimerCounter_Durations.h
 
 Some References:
 -to learn how to manipulate some of the low-level AVR code, pin change interrupts, etc, these links will help
@@ -64,6 +66,8 @@ Option 2) To measure an RC PWM servo-type signal coming from an RC Rx:
 */
 
 #include <eRCaGuy_Timer2_Counter.h>
+#include <eRCaGuy_TimestampRingBuffer.h>
+#include <eRCaGuy_TimerCounter_Durations.h>
 
 //macros
 #define fastDigitalRead(p_inputRegister, bitMask) ((*p_inputRegister & bitMask) ? HIGH : LOW)
@@ -74,10 +78,12 @@ const byte INPUT_PIN = 12; //you can change this to ANY digital or analog pin, e
 byte input_pin_bitMask;
 volatile byte* p_input_pin_register;
  
-//volatile variables for use in the ISR (Interrupt Service Routine)
-volatile boolean output_data = false; //the main loop will try to output data each time a new pulse comes in, which is when this gets set true
-volatile unsigned long pulseCounts = 0; //units of 0.5us; the input signal high pulse time
-volatile unsigned int pd = 0; //units of 0.5us; the pulse period (ie: time from start of high pulse to start of next high pulse)
+//Every edge on INPUT_PIN is timestamped in the ISR (Interrupt Service Routine) & queued here, for loop() to process. Unlike a single
+//set of volatile variables, which the ISR would overwrite if loop() was still busy printing the last pulse, this queue holds up to 
+//EDGE_BUFFER_SIZE edges, & counts (rather than silently losing) any that still don't fit.
+const byte EDGE_BUFFER_SIZE = 32; //must be a power of 2; RAM used = 32*(4+1) + 4 = 164 bytes
+typedef TimestampRingBuffer<EDGE_BUFFER_SIZE> EdgeBuffer;
+EdgeBuffer edges; //timestamps are in units of 0.5us
 
 void setup() 
 {
@@ -110,32 +116,65 @@ void setup()
   Serial.println(F(".\nData will be printed after each pulse is received."));
 }
 
+//print a value in thousandths (ex: mHz as Hz) with 3 decimal places, without using floats
+void printThousandths(unsigned long whole, unsigned int thousandths)
+{
+  Serial.print(whole);
+  Serial.print('.');
+  if (thousandths < 100) Serial.print('0');
+  if (thousandths < 10) Serial.print('0');
+  Serial.print(thousandths);
+}
+
+//print a duration in us, to the ns, without using floats; whole us + the ns left over, so it works for the full 35.79 minutes
+void printMicros(Ticks duration)
+{
+  Micros us = duration.to_micros();
+  Nanos ns_left_over = (duration - Ticks(us)).to_nanos();
+  printThousandths(us.value, ns_left_over.value);
+}
+
 void loop() 
 {
   //local variables
-  static float pulseTime = 0; //us; the most recent input signal high pulse time
-  static float pd_us = 0; //us; the most recent input signal period between pulses
-  static float pulseFreq = 0; //Hz, the most recent input signal pulse frequency
+  static Timestamp t_rise; //time of the most recent rising edge
+  static boolean have_rise = false; //true once a rising edge has been seen, so pulse widths & periods are valid
+  static unsigned int overrun_count_old = 0;
+  
+  //grab a batch of edges (as many as are waiting, up to the size of this array)
+  EdgeBuffer::Record records[8];
+  byte num_records = edges.pop(records, sizeof(records)/sizeof(records[0]));
+  
+  //Note: all of the math below is integer math; Ticks (units of 0.5us) convert to us & ns with shifts & multiplies, & to a frequency 
+  //with one integer division, so no floats are needed
+  for (byte i = 0; i < num_records; i++)
+  {
+    Timestamp t(records[i].timestamp);
+    if (records[i].pin_state == HIGH)
+    {
+      if (have_rise)
+      {
+        Ticks pd = t - t_rise; //the incoming pulse period (rising edge to rising edge)
+        Serial.print(F(", pd_us(us) = ")); printMicros(pd);
+        Serial.print(F(", pulseFreq(Hz) = ")); unsigned long mHz = pd.frequency_millihz(); printThousandths(mHz/1000, mHz%1000); Serial.println();
+      }
+      t_rise = t;
+      have_rise = true;
+    }
+    else if (have_rise) //LOW
+    {
+      Ticks pulseTime = t - t_rise; //the input signal high pulse time
+      Serial.print(F("pulsetime(us) = ")); printMicros(pulseTime);
+    }
+  }
   
-  if (output_data==true) //if a pulse just came in
+  //report any edges the buffer had no room for; if you see this, increase EDGE_BUFFER_SIZE or print less
+  unsigned int overrun_count = edges.get_overrun_count();
+  if (overrun_count != overrun_count_old)
   {
-    //turn off interrupts, grab copies of volatile data, and re-enable interrupts
-    noInterrupts();
-    output_data = false; //reset
-    unsigned long pulseCountsCopy = pulseCounts; //0.5us units
-    unsigned long pdCopy = pd; //0.5us units
-    interrupts();
-    
-    //do calculations
-    pulseTime = pulseCountsCopy/2.0; //us
-    pd_us = pdCopy/2.0; //us
-    pulseFreq = 1000000.0/pd_us; //Hz
-    
-    //print values 
-    //(optionally, add extra code here to not print after EVERY pulse is received, as this can result in serial data coming in excessively fast when pulses come in at a high freq)
-    Serial.print(F("pulsetime(us) = ")); Serial.print(pulseTime);
-    Serial.print(F(", pd_us(us) = ")); Serial.print(pd_us);
-    Serial.print(F(", pulseFreq(Hz) = ")); Serial.println(pulseFreq);
+    overrun_count_old = overrun_count;
+    Serial.print(F("\nWARNING: edges dropped so far = ")); Serial.println(overrun_count);
+    have_rise = false; //the next pulse width/period could span a dropped edge, so start over at the next rising edge
   }
 } //end of loop()
 
@@ -148,28 +187,15 @@ void loop()
 void pinChangeIntISR()
 {
   //local variables
-  static boolean pin_state_new = LOW; //initialize
   static boolean pin_state_old = LOW; //initialize
-  static unsigned long t_start = 0; //units of 0.5us
-  static unsigned long t_start_old = 0; //units of 0.5us
   
-  pin_state_new = fastDigitalRead(p_input_pin_register,input_pin_bitMask);
+  unsigned long t = timer2.get_count_in_isr(); //0.5us units; grab the time FIRST; interrupts are already off since we are in an ISR
+  boolean pin_state_new = fastDigitalRead(p_input_pin_register,input_pin_bitMask);
   if (pin_state_old != pin_state_new)
   {
     //if the pin state actualy changed, & it was not just noise lasting < ~2~4us
     pin_state_old = pin_state_new; //update the state
-    if (pin_state_new == HIGH)
-    {
-      t_start = timer2.get_count(); //0.5us units
-      pd = t_start - t_start_old; //0.5us units, the incoming pulse period
-      t_start_old = t_start; //0.5us units; update
-    }
-    else //pin_state_new == LOW
-    {
-      unsigned long t_end = timer2.get_count(); //0.5us units
-      pulseCounts = t_end - t_start; //0.5us units
-      output_data = true;
-    }
+    edges.push(t, pin_state_new); //queue the edge for loop(); never blocks
   }
 }
 
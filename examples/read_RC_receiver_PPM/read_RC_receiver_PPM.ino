@@ -0,0 +1,76 @@
+/*
+read_RC_receiver_PPM.ino
+-reads a PPM (aka CPPM, or "PPM sum") stream, which carries all channels of an RC receiver on a single wire, with 0.5us resolution,
+ using PpmDecoder from eRCaGuy_RCDecoder.h & a pin change interrupt
+-the decoder finds the start of each frame by its long sync gap, numbers the channels that follow, & hands loop() only complete
+ frames
+-prints every channel (us) of the latest frame, about 10 times per second
+
+Written: 16 Oct. 2026
+
+Circuit:
+-power the Rx by connecting 5V to + on the Rx, and GND to - on the Rx
+-connect the Rx's PPM output to PPM_PIN below (any pin except A6 & A7)
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#include <eRCaGuy_Timer2_Counter.h>
+#include <eRCaGuy_RCDecoder.h>
+
+const byte PPM_PIN = 8; //D8 is on pin change port 0 (PCINT0_vect); if you change it, change the RC_DECODER_PCINT_ISR() port below to match
+const byte MAX_CHANNELS = 8;
+
+PpmDecoder<MAX_CHANNELS> ppm; //default: 2.5ms sync gap, >= 4 channels/frame, timed rising edge to rising edge
+
+RC_DECODER_PCINT_ISR(0, ppm) //PCINT0_vect: pins D8 to D13
+
+void setup() 
+{
+  timer2.setup();
+  ppm.attach(PPM_PIN);
+  
+  Serial.begin(115200);
+  Serial.println(F("PPM channel values (us):"));
+}
+
+void loop() 
+{
+  static unsigned long t_last_print = 0; //ms
+  
+  if (millis() - t_last_print >= 100 && ppm.new_frame())
+  {
+    t_last_print = millis();
+    unsigned int channels[MAX_CHANNELS]; //0.5us units
+    byte num_channels = ppm.get_frame(channels);
+    for (byte ch = 0; ch < num_channels; ch++)
+    {
+      Serial.print(channels[ch]/2); Serial.print(channels[ch] & 1 ? F(".5\t") : F(".0\t")); //print to 0.5us without using floats
+    }
+    Serial.print(F("(frames received: ")); Serial.print(ppm.get_frame_count()); Serial.println(F(")"));
+  }
+}
@@ -0,0 +1,83 @@
+/*
+read_RC_receiver_PWM_8_channels.ino
+-reads all 8 channels of an RC receiver at once, each on its own pin, with 0.5us resolution, using PwmDecoder from
+ eRCaGuy_RCDecoder.h & pin change interrupts
+-every pin change ISR reads its whole port once & timestamps every channel that changed with a single timer2.get_count(), so
+ a full receiver costs little more CPU time than a single channel does.
+-prints all 8 pulse widths (us), about 10 times per second
+
+Written: 16 Oct. 2026
+
+Circuit:
+-power the Rx by connecting 5V to + on the Rx, and GND to - on the Rx
+-connect Rx channels 1 to 8 to the Arduino pins in CHANNEL_PINS[] below (any pins except A6 & A7 will do)
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#include <eRCaGuy_Timer2_Counter.h>
+#include <eRCaGuy_RCDecoder.h>
+
+const byte NUM_CHANNELS = 8;
+const byte CHANNEL_PINS[NUM_CHANNELS] = {2, 4, 5, 6, 7, 8, 12, 13}; //D0 to D7 are PCINT port 2, D8 to D13 are port 0
+
+PwmDecoder<NUM_CHANNELS> rx; //timed by Timer2, the same timer as the "timer2" object
+
+//one ISR per pin change port used by the pins above; each serves every channel on its port
+RC_DECODER_PCINT_ISR(0, rx) //PCINT0_vect: pins D8 to D13
+RC_DECODER_PCINT_ISR(2, rx) //PCINT2_vect: pins D0 to D7
+
+void setup() 
+{
+  timer2.setup();
+  for (byte ch = 0; ch < NUM_CHANNELS; ch++)
+    rx.attach(ch, CHANNEL_PINS[ch]);
+  
+  Serial.begin(115200);
+  Serial.println(F("Pulse widths (us) of channels 1 to 8:"));
+}
+
+void loop() 
+{
+  static unsigned long t_last_print = 0; //ms
+  static byte new_data = 0; //bit n set = channel n has updated since the last print
+  
+  new_data |= rx.get_new_data();
+  
+  if (millis() - t_last_print >= 100)
+  {
+    t_last_print = millis();
+    for (byte ch = 0; ch < NUM_CHANNELS; ch++)
+    {
+      unsigned int width = rx.get_pulse_width(ch); //0.5us units
+      Serial.print(width/2); Serial.print(width & 1 ? F(".5") : F(".0")); //print to 0.5us without using floats
+      Serial.print(new_data & _BV(ch) ? F("\t") : F("*\t")); //* = no new pulse on this channel since the last print
+    }
+    Serial.println();
+    new_data = 0;
+  }
+}
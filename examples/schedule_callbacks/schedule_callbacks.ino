@@ -0,0 +1,114 @@
+/*
+schedule_callbacks.ino
+-uses a TimerScheduler (eRCaGuy_TimerScheduler.h) to run code at exact times, with 0.5us resolution:
+ 1) a delayed pulse: each rising edge on pin 2 is echoed as a 100us pulse on pin 13, starting exactly 1000us after the edge, with
+    no delay() or polling in loop()
+ 2) a periodic callback: every 1ms, re-scheduled from its own deadline (not from "now"), so it never drifts; it also measures how
+    late it ran, & loop() prints the worst case once per second
+-watch pins 2 & 13 on a scope or logic analyzer to see the delay.
+
+Circuit: connect pin 9 (490Hz PWM output) to pin 2.
+
+NOTES:
+-the scheduler uses Timer2's compare channel A (& its TIMER2_COMPA_vect ISR), so tone(), & analogWrite() on pins 3 & 11, can't be
+ used in this sketch.
+-callbacks run inside the scheduler's ISR, with interrupts off, so they use direct port writes (PORTB) rather than digitalWrite(),
+ to stay short.
+
+Written: 16 Oct. 2026
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#include <eRCaGuy_Timer2_Counter.h>
+#include <eRCaGuy_TimerScheduler.h>
+#include <eRCaGuy_TimerCounter_Durations.h>
+
+TimerScheduler<> scheduler; //Timer2 (the "timer2" object's count), compare channel A, up to 8 pending timers
+TIMER_SCHEDULER_ISR(scheduler, 2, A);
+
+const unsigned long PULSE_DELAY = 2000; //counts (0.5us each) = 1000us
+const unsigned long PULSE_WIDTH = 200; //counts = 100us
+const unsigned long PERIOD = 2000; //counts = 1ms
+
+volatile unsigned long periodic_count = 0;
+volatile unsigned long periodic_late_max = 0; //counts
+unsigned long periodic_deadline;
+
+void pulseStart(void* arg) { PORTB |= _BV(5); } //pin 13 HIGH
+void pulseEnd(void* arg) { PORTB &= ~_BV(5); } //pin 13 LOW
+
+void periodic(void* arg)
+{
+  unsigned long late = timer2.get_count_in_isr() - periodic_deadline;
+  if (late > periodic_late_max)
+    periodic_late_max = late;
+  periodic_count++;
+  periodic_deadline += PERIOD;
+  scheduler.schedule_at(periodic_deadline, periodic);
+}
+
+void risingEdge()
+{
+  unsigned long t_edge = timer2.get_count_in_isr(); //attachInterrupt() ISRs run with interrupts off
+  scheduler.schedule_at(t_edge + PULSE_DELAY, pulseStart);
+  scheduler.schedule_at(t_edge + PULSE_DELAY + PULSE_WIDTH, pulseEnd);
+}
+
+void setup()
+{
+  pinMode(13, OUTPUT);
+  timer2.setup();
+
+  //start PWM output, to have edges to respond to
+  pinMode(9, OUTPUT);
+  analogWrite(9, 128); //490.20Hz
+
+  Serial.begin(115200);
+  Serial.println(F("begin"));
+
+  periodic_deadline = timer2.get_count() + PERIOD;
+  scheduler.schedule_at(periodic_deadline, periodic);
+  attachInterrupt(digitalPinToInterrupt(2), risingEdge, RISING);
+}
+
+void loop()
+{
+  static unsigned long t_print = millis();
+  if (millis() - t_print >= 1000)
+  {
+    t_print += 1000;
+    noInterrupts();
+    unsigned long count = periodic_count;
+    unsigned long late_max = periodic_late_max;
+    periodic_late_max = 0;
+    interrupts();
+    Serial.print(F("periodic runs = ")); Serial.print(count);
+    Serial.print(F(", worst lateness in the last second = ")); Serial.print(Ticks(late_max).to_nanos().value);
+    Serial.print(F("ns, timers pending = ")); Serial.println(scheduler.pending_count());
+  }
+}
@@ -0,0 +1,113 @@
+/*
+stream_edge_timestamps.ino
+-timestamps EVERY edge on INPUT_PIN (0.5us resolution) & streams them all to the PC in the compact binary format of
+ eRCaGuy_TimestampStream.h, instead of printing each pulse as text
+-each value sent is (timestamp << 1) | pin_state; on the wire that's ~2~3 bytes per edge, so at 115200 baud ~4000 edges/sec can be
+ logged continuously (vs. a few hundred/sec as ASCII text).  Above that, whole frames are dropped (never loop() stalled), & the
+ decoder reports how many (from the frames' 8-bit sequence #s, so a burst of 256+ lost frames in a row is reported mod 256).
+-the shift drops the count's top bit, so the timestamps sent are 31 bits & wrap every 2^31 counts (1073.7 sec = ~17.9 min @
+ 0.5us/count); the decoder outputs them as sent, so add 2^31 each time the timestamp goes back.  Times between edges are fine
+ across the wrap as long as they're < 2^31 counts, if subtracted mod 2^31.
+-edges the ISR can't fit into the ring buffer (if loop() falls behind) are lost before they reach the stream, so once a second
+ the ring buffer's overrun total is sent too, as a tagged value (TAG_OVERRUN_COUNT), & the decoder reports it.
+-to decode, build & run the host decoder in extras/timestamp_stream_decoder/ (see the top of its .cpp file), ex: on Linux:
+   stty -F /dev/ttyUSB0 115200 raw -echo
+   ./timestamp_stream_decoder --edges < /dev/ttyUSB0 > edges.csv
+ (The Serial Monitor will only show gibberish, since the data is binary.)
+
+Circuit: same as the read_PWM_pulses_on_ANY_pin_via_pin_change_interrupt example: connect pin 9 (490Hz PWM output) to INPUT_PIN.
+
+Written: 16 Oct. 2026
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#include <eRCaGuy_Timer2_Counter.h>
+#include <eRCaGuy_TimestampRingBuffer.h>
+#include <eRCaGuy_TimestampStream.h>
+#include <eRCaGuy_RCDecoder.h> //for RCDecoderPcint only
+
+const byte INPUT_PIN = 12; //any pin with a pin change interrupt, ie: any digital or analog pin except A6 & A7
+byte input_port; //pin change port (0 = PINB, 1 = PINC, 2 = PIND) & bit of INPUT_PIN
+byte input_bitMask;
+
+TimestampRingBuffer<32> edges; //ISR --> loop()
+TimestampStreamEncoder<> stream; //loop() --> Serial
+const unsigned long OVERRUN_REPORT_PERIOD_MS = 1000;
+unsigned long t_overrun_report = 0; //millis()
+
+void setup()
+{
+  pinMode(INPUT_PIN, INPUT_PULLUP);
+  timer2.setup();
+
+  //start PWM output, to have something to read in
+  pinMode(9, OUTPUT);
+  analogWrite(9, 128); //490.20Hz, ~1020us high pulses
+
+  Serial.begin(115200);
+
+  byte bit;
+  RCDecoderPcint::pin_to_port_bit(INPUT_PIN, input_port, bit);
+  input_bitMask = _BV(bit);
+  RCDecoderPcint::enable(input_port, bit);
+}
+
+void loop()
+{
+  //move edges from the ISR's buffer into the stream
+  TimestampRingBuffer<32>::Record records[8];
+  byte num_records = edges.pop(records, sizeof(records)/sizeof(records[0]));
+  for (byte i = 0; i < num_records; i++)
+    stream.add((records[i].timestamp << 1) | records[i].pin_state); //31-bit timestamp; see above
+
+  //the running total is resent each time, so a dropped frame only delays it
+  if (millis() - t_overrun_report >= OVERRUN_REPORT_PERIOD_MS)
+  {
+    t_overrun_report += OVERRUN_REPORT_PERIOD_MS;
+    stream.add_tagged(TimestampStreamFormat::TAG_OVERRUN_COUNT, edges.get_overrun_count());
+  }
+
+  stream.service(Serial); //never blocks
+}
+
+void pinChangeIntISR(byte port)
+{
+  static byte pin_state_old = LOW;
+  unsigned long t = timer2.get_count_in_isr(); //grab the time FIRST
+  byte pin_state_new = (RCDecoderPcint::read_port(port) & input_bitMask) ? HIGH : LOW;
+  if (pin_state_new != pin_state_old)
+  {
+    pin_state_old = pin_state_new;
+    edges.push(t, pin_state_new); //never blocks; the ring buffer counts any overruns
+  }
+}
+
+//only INPUT_PIN's port's interrupt is enabled, so only one of these ever runs
+ISR(PCINT0_vect) { pinChangeIntISR(0); }
+ISR(PCINT1_vect) { pinChangeIntISR(1); }
+ISR(PCINT2_vect) { pinChangeIntISR(2); }
@@ -0,0 +1,134 @@
+/*
+tickless_polling.ino
+-uses a TimerCounterTickless (eRCaGuy_TimerCounter_Tickless.h) to poll an input pin in a tight loop with the Timer2 overflow ISR
+ turned off, & shows that the count stays correct anyway:
+ 1) it counts how many times a tight polling loop runs in 100ms, with & without tickless mode, to show what the overflow ISR costs
+ 2) it turns interrupts off for 500us (~4 overflow periods), as a badly behaved library might, & shows that the overflows lost
+    are detected & reported, rather than giving the wrong time
+ 3) it measures the width of the pulses on pin 2 (ex: from a function generator, or an RC receiver) by polling the pin directly,
+    with no interrupts at all, & prints the last one, once a second.  Printing pauses the polling, so the watchdog turns the
+    overflow ISR back on each time; the # of times this happened is printed too.
+-with nothing connected to pin 2, step 3 just reports "no pulse"
+
+Written: 16 Oct. 2026
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#include <eRCaGuy_Timer2_Counter.h>
+#include <eRCaGuy_TimerCounter_Tickless.h>
+#include <eRCaGuy_TimerCounter_Durations.h>
+
+TimerCounterTickless<> tickless; //Timer2 (the "timer2" object's count), compare channel B, checked against micros()
+TIMER_COUNTER_TICKLESS_ISR(tickless, 2, B);
+
+const byte INPUT_PIN = 2; //PD2 on an Uno/Nano/Pro Mini
+
+//poll for 100ms (200000 counts); returns the # of times the loop ran
+unsigned long countPolls(bool use_tickless)
+{
+  unsigned long polls = 0;
+  if (use_tickless)
+  {
+    tickless.enter();
+    unsigned long t_start = tickless.get_count_unchecked();
+    while (tickless.get_count_unchecked() - t_start < 200000)
+      polls++;
+    tickless.exit();
+  }
+  else
+  {
+    unsigned long t_start = timer2.get_count();
+    while (timer2.get_count() - t_start < 200000)
+      polls++;
+  }
+  return polls;
+}
+
+void setup()
+{
+  pinMode(INPUT_PIN, INPUT_PULLUP);
+  timer2.setup();
+  Serial.begin(115200);
+  Serial.println(F("begin"));
+  Serial.flush();
+
+  //1) the cost of the overflow ISR in a tight loop
+  unsigned long polls_normal = countPolls(false);
+  unsigned long polls_tickless = countPolls(true);
+  Serial.print(F("Polls in 100ms: normal = ")); Serial.print(polls_normal);
+  Serial.print(F(", tickless = ")); Serial.println(polls_tickless);
+
+  //2) a lost overflow is reported, not hidden
+  unsigned long count;
+  tickless.enter();
+  tickless.get_count_unchecked();
+  noInterrupts();
+  delayMicroseconds(500); //neither the watchdog nor the overflow ISR can run
+  interrupts();
+  bool ok = tickless.get_count_checked(count);
+  Serial.print(F("After 500us with interrupts off: count ok = ")); Serial.print(ok ? F("yes") : F("NO"));
+  Serial.print(F(", overflows lost = ")); Serial.println(tickless.get_lost_overflow_count());
+  tickless.clear_lost_overflow_count();
+  Serial.flush();
+  //still in tickless mode; it stays on from here on
+}
+
+//3) pulse widths, measured by polling
+void loop()
+{
+  static bool level_old = digitalRead(INPUT_PIN);
+  static unsigned long t_rise = 0;
+  static unsigned long pulse_counts = 0; //0 = no pulse yet
+  static unsigned long t_print = tickless.get_count_unchecked();
+
+  unsigned long t_now = tickless.get_count_unchecked();
+  bool level = PIND & _BV(INPUT_PIN); //much faster than digitalRead()
+  if (level != level_old)
+  {
+    if (level)
+      t_rise = t_now;
+    else
+      pulse_counts = t_now - t_rise;
+    level_old = level;
+  }
+
+  if (t_now - t_print >= 2000000) //1 sec
+  {
+    t_print += 2000000;
+    unsigned long count;
+    bool ok = tickless.get_count_checked(count);
+    if (pulse_counts)
+    {
+      Serial.print(F("pulse width = ")); Serial.print(Ticks(pulse_counts).to_nanos().value); Serial.print(F(" ns"));
+    }
+    else
+      Serial.print(F("no pulse"));
+    Serial.print(F("; watchdog went off ")); Serial.print(tickless.get_watchdog_count());
+    Serial.print(F(" times; time ok = ")); Serial.println(ok ? F("yes") : F("NO"));
+  }
+}
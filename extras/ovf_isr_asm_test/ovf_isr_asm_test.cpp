@@ -0,0 +1,306 @@
+/*
+ovf_isr_asm_test.cpp
+-host (PC) test of the assembly overflow ISR (TIMER_COUNTER_FAST_OVF_ISR 1) in eRCaGuy_TimerCounter.h.  Host builds can't compile
+ that ISR (they always use the C++ one), so this test reads the ISR's instructions straight out of the header's
+ TIMER_COUNTER_OVF_ISR() macro, & runs them on a tiny interpreter of the few AVR instructions it uses (push, pop, in, out, lds,
+ sts, inc, brne, reti).  Any other instruction or register is reported as an error, so the test can't silently drift from the
+ header.
+-checked, from every combination of the bytes 0x00, 0x01, 0xFE, & 0xFF in each of the 6 bytes of overflow_count (4) &
+ overflow_count_hi (2), ie: every carry chain, including the 0xFF...FF rollovers of both:
+ 1) the result is the same as TimerCounter::increment_overflow_count()'s, the C++ ISR's body
+ 2) r24 & SREG (every flag) are restored, the stack is balanced, & it ends with "reti"
+ 3) its cycle count: 28 for no carry (TIMER_COUNTER_OVF_ISR_CYCLES' hand count), + 6 for each further byte the carry reaches.
+    NB: this only re-adds the instruction set manual's cycle counts, the same way the hand count did; it is NOT a measurement
+    (see the benchmark_cycles example for that).
+
+Build & run (Linux/Mac, from the library's root folder):
+  g++ -std=gnu++11 -O2 -Wall -I. extras/ovf_isr_asm_test/ovf_isr_asm_test.cpp -o ovf_isr_asm_test
+  ./ovf_isr_asm_test [path to eRCaGuy_TimerCounter.h, default ./eRCaGuy_TimerCounter.h]
+Exit status: 0 if every check passed, 1 otherwise.
+
+Written: 16 Oct. 2026
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#include "eRCaGuy_TimerCounter.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+typedef TimerCounter<2,8> Counter;
+typedef TimerCounterState<2> State;
+
+//the cycle counts this test expects: the hand count in eRCaGuy_TimerCounter.h (TIMER_COUNTER_OVF_ISR_CYCLES for the assembly
+//ISR), & what each further byte of carry adds (lds 2 + inc 1 + sts 2, & the previous brne not taken: 1 instead of 2)
+static const uint32_t EXPECTED_CYCLES = 28;
+static const uint32_t EXPECTED_CYCLES_PER_CARRY = 6;
+static const uint32_t ENTRY_CYCLES = 4 + 3; //interrupt response + the "jmp" in the vector table
+
+static unsigned long failures = 0;
+
+static void fail(const std::string& what)
+{
+  failures++;
+  if (failures <= 20)
+    printf("  FAIL: %s\n", what.c_str());
+}
+
+//---------------------------------------------------------------------------------------------------
+//Reading the ISR out of the header
+//---------------------------------------------------------------------------------------------------
+//the instruction strings of the first TIMER_COUNTER_OVF_ISR() macro (the assembly one), ex: "lds  r24, %[ovf]+1"
+static std::vector<std::string> read_isr(const char* path)
+{
+  std::vector<std::string> instructions;
+  std::ifstream file(path);
+  if (!file)
+  {
+    fail(std::string("can't open ") + path);
+    return instructions;
+  }
+  std::string line;
+  bool in_macro = false, in_asm = false;
+  while (std::getline(file, line))
+  {
+    if (!in_macro)
+    {
+      in_macro = line.find("#define TIMER_COUNTER_OVF_ISR(TIMER_ID)") == 0;
+      continue;
+    }
+    if (line.find("__asm__") != std::string::npos)
+    {
+      in_asm = true;
+      continue;
+    }
+    if (!in_asm)
+      continue;
+    size_t first = line.find('"');
+    if (first == std::string::npos) //the ":" lines of the operands: the end of the instructions
+      break;
+    size_t last = line.find("\\n\\t\"", first + 1);
+    if (last == std::string::npos)
+    {
+      fail("unexpected line in the asm: " + line);
+      break;
+    }
+    instructions.push_back(line.substr(first + 1, last - first - 1));
+  }
+  if (instructions.empty())
+    fail("no assembly overflow ISR found");
+  return instructions;
+}
+
+//---------------------------------------------------------------------------------------------------
+//The interpreter
+//---------------------------------------------------------------------------------------------------
+struct Machine
+{
+  uint8_t ovf[4]; //overflow_count, little-endian, as on the AVR
+  uint8_t ovf_hi[2]; //overflow_count_hi
+  uint8_t r24;
+  uint8_t sreg;
+  std::vector<uint8_t> stack;
+  uint32_t cycles;
+};
+
+static const uint8_t SREG_Z = 1, SREG_N = 2, SREG_V = 3, SREG_S = 4;
+
+static std::string trim(const std::string& s)
+{
+  size_t a = s.find_first_not_of(" \t"), b = s.find_last_not_of(" \t");
+  return a == std::string::npos ? "" : s.substr(a, b - a + 1);
+}
+
+//the byte a memory operand, ex: "%[ovf]+2", refers to; NULL if it isn't one of the 6 bytes
+static uint8_t* memory(Machine& m, const std::string& operand)
+{
+  std::string name = operand, offset = "0";
+  size_t plus = operand.find('+');
+  if (plus != std::string::npos)
+  {
+    name = trim(operand.substr(0, plus));
+    offset = trim(operand.substr(plus + 1));
+  }
+  int k = atoi(offset.c_str());
+  if (name == "%[ovf]" && k >= 0 && k < 4)
+    return &m.ovf[k];
+  if (name == "%[ovf_hi]" && k >= 0 && k < 2)
+    return &m.ovf_hi[k];
+  fail("bad memory operand: " + operand);
+  return NULL;
+}
+
+static bool is_r24(const std::string& operand)
+{
+  if (operand == "r24")
+    return true;
+  fail("uses a register other than r24, which it doesn't save: " + operand);
+  return false;
+}
+
+//run the ISR once; returns false if it couldn't be run to its "reti"
+static bool run(const std::vector<std::string>& isr, Machine& m)
+{
+  m.cycles = ENTRY_CYCLES;
+  size_t pc = 0;
+  for (uint32_t steps = 0; pc < isr.size() && steps < 1000; steps++)
+  {
+    std::string text = trim(isr[pc++]);
+    if (text.empty() || text[text.size() - 1] == ':') //a label
+      continue;
+    std::istringstream in(text);
+    std::string op, args;
+    in >> op;
+    std::getline(in, args);
+    std::string a = trim(args), b;
+    size_t comma = a.find(',');
+    if (comma != std::string::npos)
+    {
+      b = trim(a.substr(comma + 1));
+      a = trim(a.substr(0, comma));
+    }
+    if (op == "push" && is_r24(a)) { m.stack.push_back(m.r24); m.cycles += 2; }
+    else if (op == "pop" && is_r24(a))
+    {
+      if (m.stack.empty()) { fail("pop from an empty stack"); return false; }
+      m.r24 = m.stack.back(); m.stack.pop_back(); m.cycles += 2;
+    }
+    else if (op == "in" && is_r24(a) && b == "__SREG__") { m.r24 = m.sreg; m.cycles += 1; }
+    else if (op == "out" && a == "__SREG__" && is_r24(b)) { m.sreg = m.r24; m.cycles += 1; }
+    else if (op == "lds" && is_r24(a)) { uint8_t* p = memory(m, b); if (!p) return false; m.r24 = *p; m.cycles += 2; }
+    else if (op == "sts" && is_r24(b)) { uint8_t* p = memory(m, a); if (!p) return false; *p = m.r24; m.cycles += 2; }
+    else if (op == "inc" && is_r24(a))
+    {
+      m.r24++;
+      bool z = m.r24 == 0, n = m.r24 & 0x80, v = m.r24 == 0x80;
+      m.sreg &= (uint8_t)~(_BV(SREG_Z) | _BV(SREG_N) | _BV(SREG_V) | _BV(SREG_S));
+      m.sreg |= (uint8_t)((z ? _BV(SREG_Z) : 0) | (n ? _BV(SREG_N) : 0) | (v ? _BV(SREG_V) : 0) | ((n != v) ? _BV(SREG_S) : 0));
+      m.cycles += 1;
+    }
+    else if (op == "brne" && a == "1f")
+    {
+      if (m.sreg & _BV(SREG_Z))
+        m.cycles += 1;
+      else
+      {
+        m.cycles += 2;
+        while (pc < isr.size() && trim(isr[pc]) != "1:")
+          pc++;
+        if (pc == isr.size()) { fail("brne 1f: no label 1: after it"); return false; }
+      }
+    }
+    else if (op == "reti") { m.cycles += 4; return true; }
+    else
+    {
+      fail("unknown instruction: " + text);
+      return false;
+    }
+  }
+  fail("ran off the end without a reti");
+  return false;
+}
+
+//---------------------------------------------------------------------------------------------------
+//Main
+//---------------------------------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  const char* path = argc > 1 ? argv[1] : "eRCaGuy_TimerCounter.h";
+  std::vector<std::string> isr = read_isr(path);
+  printf("assembly overflow ISR from %s: %u lines\n", path, (unsigned)isr.size());
+  if (isr.empty())
+    return 1;
+
+  static const uint8_t BYTES[] = {0x00, 0x01, 0xFE, 0xFF};
+  unsigned long cases = 0;
+  for (uint32_t combo = 0; combo < 4096; combo++) //4 values in each of 6 bytes
+  {
+    Machine m;
+    for (uint8_t k = 0; k < 6; k++)
+    {
+      uint8_t byte = BYTES[(combo >> 2*k) & 3];
+      if (k < 4)
+        m.ovf[k] = byte;
+      else
+        m.ovf_hi[k - 4] = byte;
+    }
+    uint32_t overflow_count = m.ovf[0] | (uint32_t)m.ovf[1] << 8 | (uint32_t)m.ovf[2] << 16 | (uint32_t)m.ovf[3] << 24;
+    uint16_t overflow_count_hi = (uint16_t)(m.ovf_hi[0] | m.ovf_hi[1] << 8);
+    const uint8_t R24 = (uint8_t)(0x5A ^ combo), SREG_IN = (uint8_t)(combo*37); //arbitrary: the main code's values
+    m.r24 = R24;
+    m.sreg = SREG_IN;
+
+    //1) vs. the C++ ISR's body
+    State::overflow_count.hw_write(overflow_count);
+    State::overflow_count_hi.hw_write(overflow_count_hi);
+    Counter::increment_overflow_count();
+    uint32_t expected = State::overflow_count.hw_read();
+    uint16_t expected_hi = State::overflow_count_hi.hw_read();
+
+    if (!run(isr, m))
+      break;
+    cases++;
+    uint32_t got = m.ovf[0] | (uint32_t)m.ovf[1] << 8 | (uint32_t)m.ovf[2] << 16 | (uint32_t)m.ovf[3] << 24;
+    uint16_t got_hi = (uint16_t)(m.ovf_hi[0] | m.ovf_hi[1] << 8);
+    char start[64];
+    snprintf(start, sizeof(start), "from %04X:%08X", overflow_count_hi, overflow_count);
+    if (got != expected || got_hi != expected_hi)
+    {
+      char result[96];
+      snprintf(result, sizeof(result), ": got %04X:%08X, increment_overflow_count() gives %04X:%08X", got_hi, got,
+               expected_hi, expected);
+      fail(std::string(start) + result);
+    }
+
+    //2)
+    if (m.r24 != R24 || m.sreg != SREG_IN || !m.stack.empty())
+      fail(std::string(start) + ": r24, SREG, or the stack not restored");
+
+    //3) the # of bytes the carry reaches beyond the first
+    uint8_t carries = 0;
+    while (carries < 5 && (carries < 4 ? m.ovf[carries] : m.ovf_hi[carries - 4]) == 0)
+      carries++;
+    uint32_t expected_cycles = EXPECTED_CYCLES + EXPECTED_CYCLES_PER_CARRY*carries;
+    if (carries == 5) //the last byte has no brne after it, so it saves the 2 cycles of a taken one
+      expected_cycles -= 2;
+    if (m.cycles != expected_cycles)
+    {
+      char result[64];
+      snprintf(result, sizeof(result), ": %u cycles, expected %u", m.cycles, expected_cycles);
+      fail(std::string(start) + result);
+    }
+  }
+
+  printf("%lu cases, %lu failures\n", cases, failures);
+  printf(failures ? "FAIL\n" : "PASS\n");
+  return failures ? 1 : 0;
+}
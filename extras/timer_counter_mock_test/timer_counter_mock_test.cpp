@@ -0,0 +1,186 @@
+/*
+timer_counter_mock_test.cpp
+-host (PC) unit test of the TimerCounter<TIMER_ID,PRESCALER> specializations for Timer0, Timer1, & Timer2, run against the RAM
+ registers of eRCaGuy_TimerCounter_mock.h (no timer ticks on its own here; each test sets the registers itself):
+ 1) setup(): the clock select bits written to TCCRnB for every prescaler each timer supports, checked against the datasheet's
+    "Clock Select Bit Description" tables, & the normal-mode (WGM) bits & the overflow interrupt enable; then
+    revert_to_normal() puts TCCRnA & TCCRnB back
+ 2) get_count() & get_count64(): TCNTn & the overflow count composed into 1 count, for the 8-bit timers (TCNT = the low byte)
+    & the 16-bit Timer1 (TCNT1 = the low 2 bytes)
+ 3) the overflow-pending path: with TOVn set, the overflow is counted by get_count() itself (carrying into overflow_count_hi
+    when overflow_count rolls over), & TOVn is cleared by writing a 1 to it, leaving the other flags in TIFRn set
+ 4) eRCaGuy_TimerCounter_Durations.h's frequency_hz() & frequency_millihz(), against the same division done in 64 bits, over
+    periods from 1 count up to 2^32 - 1, including TimerCounter<1,1>'s 1 to 3 count periods, where frequency_millihz() saturates
+-to see the test fail, break one of the above in eRCaGuy_TimerCounter.h, ex: a wrong clock_select() entry
+
+Build & run (Linux/Mac, from the library's root folder):
+  g++ -std=gnu++11 -O2 -Wall -I. extras/timer_counter_mock_test/timer_counter_mock_test.cpp -o timer_counter_mock_test
+  ./timer_counter_mock_test
+Exit status: 0 if every check passed, 1 otherwise.
+
+Written: 16 Oct. 2026
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#include "eRCaGuy_TimerCounter.h"
+#include "eRCaGuy_TimerCounter_Durations.h"
+
+#include <cstdio>
+
+static unsigned long checks = 0;
+static unsigned long failures = 0;
+
+static void check(bool ok, const char* what, uint8_t timer_id, unsigned long detail)
+{
+  checks++;
+  if (!ok)
+  {
+    failures++;
+    printf("FAIL: Timer%u: %s (%lu)\n", timer_id, what, detail);
+  }
+}
+
+//the registers of one timer, by TIMER_ID, through the same traits the library uses
+template <uint8_t TIMER_ID>
+struct Test
+{
+  typedef TimerCounterRegs<TIMER_ID> Regs;
+  typedef TimerCounterState<TIMER_ID> State;
+  typedef typename Regs::count_t count_t;
+
+  //1) setup() with prescaler PRESCALER must write CS bits "cs"
+  template <uint16_t PRESCALER>
+  static void setup(uint8_t cs)
+  {
+    typedef TimerCounter<TIMER_ID, PRESCALER> Counter;
+    TimerCounterMockIo<>::reset_all();
+    const uint8_t tccra_old = 0xFF; //every WGM bit set, as if another library had used the timer
+    const uint8_t tccrb_old = (uint8_t)(Regs::WGM_B_MASK | 0x07); //WGM bits, & a clock select setting of 7 (an external clock)
+    Regs::tccra().hw_write(tccra_old);
+    Regs::tccrb().hw_write(tccrb_old);
+    Counter::setup();
+    check((Regs::tccrb().hw_read() & Regs::CS_MASK) == cs, "setup() clock select bits", TIMER_ID, PRESCALER);
+    check((Regs::tccra().hw_read() & Regs::WGM_A_MASK) == 0 && (Regs::tccrb().hw_read() & Regs::WGM_B_MASK) == 0,
+          "setup() normal mode", TIMER_ID, PRESCALER);
+    check(Regs::timsk().hw_read() == _BV(Regs::TOIE_BIT), "setup() overflow interrupt on, & nothing else", TIMER_ID, PRESCALER);
+    Counter::revert_to_normal();
+    check(Regs::tccra().hw_read() == tccra_old && Regs::tccrb().hw_read() == tccrb_old, "revert_to_normal() restores TCCRnA/B",
+          TIMER_ID, PRESCALER);
+    check(Regs::timsk().hw_read() == 0, "revert_to_normal() overflow interrupt off", TIMER_ID, PRESCALER);
+  }
+
+  //2) & 3) get_count() & get_count64() with the given state
+  static void count(uint16_t overflow_count_hi, uint32_t overflow_count, count_t tcnt, bool tov_pending)
+  {
+    typedef TimerCounter<TIMER_ID, 8> Counter;
+    const uint8_t OTHER_FLAGS = _BV(Regs::OCFA_BIT) | _BV(Regs::OCFB_BIT);
+    TimerCounterMockIo<>::reset_all();
+    SREG.hw_write(_BV(SREG_I));
+    for (uint8_t call = 0; call < 3; call++)
+    {
+      State::overflow_count_hi.hw_write(overflow_count_hi);
+      State::overflow_count.hw_write(overflow_count);
+      Regs::tcnt().hw_write(tcnt);
+      Regs::tifr().hw_write((uint8_t)(OTHER_FLAGS | (tov_pending ? _BV(Regs::TOV_BIT) : 0)));
+
+      //the expected count, the slow way
+      uint64_t overflows = ((uint64_t)overflow_count_hi << 32) + overflow_count + (tov_pending ? 1 : 0);
+      uint64_t expected = (overflows << Regs::COUNTER_BITS) + tcnt;
+      uint64_t got = call == 0 ? Counter::get_count() : call == 1 ? Counter::get_count_in_isr() : Counter::get_count64();
+      if (call == 1)
+        check(SREG.hw_read() == _BV(SREG_I), "get_count_in_isr() leaves SREG alone", TIMER_ID, call);
+      else
+        check(SREG.hw_read() == _BV(SREG_I), "interrupts back on afterwards", TIMER_ID, call);
+      if (call < 2)
+        check(got == (uint32_t)expected, "32-bit count composed from TCNT & the overflow count", TIMER_ID, (unsigned long)got);
+      else
+        check(got == (expected & (Regs::COUNTER_BITS == 8 ? 0x00FFFFFFFFFFFFFFULL : 0xFFFFFFFFFFFFFFFFULL)),
+              "64-bit count composed from TCNT & both overflow counts", TIMER_ID, (unsigned long)got);
+      check((uint64_t)((uint64_t)State::overflow_count_hi.hw_read() << 32 | State::overflow_count.hw_read()) == overflows,
+            "a pending overflow is counted, & carried into overflow_count_hi", TIMER_ID, overflow_count);
+      check(Regs::tifr().hw_read() == OTHER_FLAGS, "TOV cleared by writing a 1 to it, & ONLY TOV", TIMER_ID,
+            Regs::tifr().hw_read());
+    }
+  }
+
+  static void counts()
+  {
+    const count_t TCNT_MAX = (count_t)~(count_t)0;
+    const uint32_t OVERFLOW_COUNTS[] = {0, 1, 0x12345678, 0x00FFFFFF, 0xFFFFFFFE, 0xFFFFFFFF};
+    const count_t TCNTS[] = {0, 1, (count_t)(TCNT_MAX/2), (count_t)(TCNT_MAX - 1), TCNT_MAX};
+    for (uint8_t i = 0; i < sizeof(OVERFLOW_COUNTS)/sizeof(OVERFLOW_COUNTS[0]); i++)
+      for (uint8_t j = 0; j < sizeof(TCNTS)/sizeof(TCNTS[0]); j++)
+        for (uint8_t pending = 0; pending < 2; pending++)
+        {
+          count(0, OVERFLOW_COUNTS[i], TCNTS[j], pending);
+          count(0xABCD, OVERFLOW_COUNTS[i], TCNTS[j], pending);
+        }
+  }
+};
+
+//4) frequency_hz() & frequency_millihz() of every period, rounded to nearest & saturated, the slow way
+template <uint8_t TIMER_ID, uint16_t PRESCALER>
+static void frequencies()
+{
+  typedef TimerCounter<TIMER_ID, PRESCALER> Counter;
+  check(TimerCounterTicks<Counter>(0).frequency_hz() == 0 && TimerCounterTicks<Counter>(0).frequency_millihz() == 0,
+        "frequency of a 0 period is 0", TIMER_ID, PRESCALER);
+  for (uint64_t period = 1; period <= 0xFFFFFFFFULL; period += period < 5000 ? 1 : period/997 + 1)
+  {
+    TimerCounterTicks<Counter> ticks((uint32_t)period);
+    uint64_t hz = (Counter::COUNTS_PER_SECOND + period/2)/period;
+    uint64_t millihz = ((uint64_t)Counter::COUNTS_PER_SECOND*1000 + period/2)/period;
+    if (millihz > 0xFFFFFFFFULL)
+      millihz = 0xFFFFFFFFULL;
+    check(ticks.frequency_hz() == hz, "frequency_hz()", TIMER_ID, (unsigned long)period);
+    check(ticks.frequency_millihz() == millihz, "frequency_millihz(), saturated at 0xFFFFFFFF", TIMER_ID, (unsigned long)period);
+  }
+}
+
+int main()
+{
+  //1) datasheet clock select tables: Timer0 & Timer1 (pg. 110 & 137) share one, Timer2 (pg. 162) has its own
+  Test<0>::setup<1>(1); Test<0>::setup<8>(2); Test<0>::setup<64>(3); Test<0>::setup<256>(4); Test<0>::setup<1024>(5);
+  Test<1>::setup<1>(1); Test<1>::setup<8>(2); Test<1>::setup<64>(3); Test<1>::setup<256>(4); Test<1>::setup<1024>(5);
+  Test<2>::setup<1>(1); Test<2>::setup<8>(2); Test<2>::setup<32>(3); Test<2>::setup<64>(4); Test<2>::setup<128>(5);
+  Test<2>::setup<256>(6); Test<2>::setup<1024>(7);
+
+  //2) & 3)
+  Test<0>::counts();
+  Test<1>::counts();
+  Test<2>::counts();
+
+  //4)
+  frequencies<1,1>(); //periods of 1 to 3 counts saturate
+  frequencies<2,8>();
+  frequencies<2,1024>();
+
+  printf("%lu checks, %lu failures\n", checks, failures);
+  printf(failures ? "FAIL\n" : "PASS\n");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,327 @@
+/*
+latency_probe_fuzz.cpp
+-host (PC) harness for LatencyProbe (eRCaGuy_LatencyProbe.h), run against the Timer2 simulation in timer_counter_sim.h, with its
+ compare match ISR (channel B) & the overflow ISR dispatched by the simulation as on the AVR
+-2 sources, in turn: SOURCE_IDLE (the main code just calls get_count(), so only the overflow ISR & short interrupts-off sections
+ delay the probe), & SOURCE_BURSTS (the main code also turns interrupts off for random bursts of up to ~70 counts)
+-the probe ISR is wrapped, so that the harness knows, for every probe, the true count at which its compare match flag was set &
+ at which its ISR was entered, & the last interrupts-off burst the main code made; it checks:
+ 1) each latency the probe records is the real delay from its flag being set to its ISR reading TCNT2: at least as long as the
+    rest of any burst the flag was set in, & no more than the rest of the burst which delayed it (if any) + IDLE_BOUND_COUNTS
+    (the overflow ISR, & the library's own short interrupts-off sections)
+ 2) the statistics (count, min, max, sum) & percentile() are exactly those of the latencies recorded
+ 3) probes are taken at the rate start() asks for: on average 1 per interval (within 10%)
+ 4) set_correction_to_min() sets the idle minimum, & correct() subtracts it
+ 5) record(): when a histogram bucket fills up, all are halved, & the percentiles stay right
+ 6) the bursts show up in the statistics: SOURCE_BURSTS' max is above SOURCE_IDLE's max + half the longest burst
+ 7) percentile() with saturated buckets, where total*per_mille overflows 32 bits: every bucket of a 255-bucket histogram full,
+    checked against the same walk done in 64 bits
+ 8) a probe whose compare match interrupt is turned off by something else is given up on, counted by get_missed_count(), &
+    replaced, between 1 & MISSED_OVERFLOWS + 1 overflow periods later; & no probe was missed in the main run above
+
+Build & run (Linux/Mac, from the library's root folder):
+  g++ -std=gnu++11 -O2 -Wall -I. -Iextras/timer_counter_sim extras/timer_counter_sim/latency_probe_fuzz.cpp -o latency_probe_fuzz
+  ./latency_probe_fuzz [main loop iterations per source, default 300000] [seed, default 1]
+Exit status: 0 if every check passed, 1 otherwise.
+
+Written: 16 Oct. 2026
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#include "eRCaGuy_TimerCounter.h"
+#include "timer_counter_sim.h"
+#include "eRCaGuy_LatencyProbe.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+typedef TimerCounter<2,8> Counter;
+TIMER_COUNTER_OVF_ISR(2)
+
+enum { SOURCE_IDLE, SOURCE_BURSTS, NUM_SOURCES };
+typedef LatencyProbe<NUM_SOURCES, Counter> Probe;
+Probe probe;
+static const uint8_t NUM_BUCKETS = sizeof(Probe::Stats().histogram)/sizeof(uint16_t);
+typedef LatencyProbe<1, Counter, TIMER_COUNTER_CHANNEL_B, 255> WideProbe; //only its static percentile() is used, for 7)
+
+//the most a probe may be delayed beyond any burst its flag was set in, in counts of 0.5us: the probe ISR's own entry (~3 counts,
+//at the simulation's cycles per access), + an overflow ISR which may run first (~8 counts), + the library's short interrupts-off
+//sections in get_count() & service().  Over 100 seeds, the worst seen was 14 counts.
+static const uint32_t IDLE_BOUND_COUNTS = 20;
+static const uint32_t INTERVAL_COUNTS = 500;
+static const uint32_t MAX_BURST_ACCESSES = 200; //~70 counts, at 1 to 4 cycles per access
+
+static unsigned long failures = 0;
+
+static void fail(const char* what, unsigned long a, unsigned long b)
+{
+  failures++;
+  if (failures <= 20)
+    printf("  FAIL: %s (%lu, %lu)\n", what, a, b);
+}
+
+//the main code's last interrupts-off burst, in true counts: interrupts were off from at least "start" until at least "end"
+static uint64_t burst_start = 0, burst_end = 0;
+static uint32_t longest_burst = 0;
+
+static std::vector<uint16_t> latencies[NUM_SOURCES]; //every latency the probe recorded, per source
+static uint64_t sum_old[NUM_SOURCES];
+
+//the probe ISR (what LATENCY_PROBE_ISR(probe, 2, B) creates), wrapped to check 1)
+ISR(TIMER2_COMPB_vect)
+{
+  uint64_t entered = Timer2Sim::get_true_count();
+  uint8_t target = (uint8_t)(OCR2B.hw_read() + 1); //see service(): OCR2B = target - 1
+  uint64_t flagged = entered - (uint8_t)((uint8_t)entered - target); //the last count, at or before entry, with target's low byte
+  uint8_t source = probe.get_source();
+
+  probe.on_compare_match();
+
+  Probe::Stats stats;
+  probe.get_stats(source, stats);
+  uint32_t latency = (uint32_t)(stats.sum - sum_old[source]);
+  sum_old[source] = stats.sum;
+  latencies[source].push_back((uint16_t)latency);
+  uint32_t delay = (uint32_t)(entered - flagged); //from the flag being set to the ISR being dispatched
+  if (latency < delay || latency > delay + 1)
+    fail("1) the latency recorded isn't the real delay, from the compare match flag to the ISR reading TCNT2", latency, delay);
+  //a burst which starts shortly AFTER the flag is set can delay the probe too, ex: if an overflow ISR runs first, the AVR always
+  //runs 1 more main-code instruction after its "reti", which may be the burst's cli()
+  uint32_t burst_rest = 0;
+  if (flagged < burst_end && flagged + IDLE_BOUND_COUNTS >= burst_start)
+    burst_rest = (uint32_t)(burst_end - flagged);
+  if (burst_start <= flagged && latency < burst_rest)
+    fail("1) the latency recorded is shorter than the rest of the interrupts-off burst the flag was set in", latency, burst_rest);
+  if (latency > burst_rest + IDLE_BOUND_COUNTS)
+    fail("1) the latency recorded is more than IDLE_BOUND_COUNTS beyond the burst which delayed it", latency, burst_rest);
+}
+
+//2) the statistics & percentiles are exactly those of the latencies recorded
+static void check_stats(uint8_t source)
+{
+  Probe::Stats stats;
+  probe.get_stats(source, stats);
+  std::vector<uint16_t> sorted = latencies[source];
+  std::sort(sorted.begin(), sorted.end());
+  uint64_t sum = 0;
+  for (size_t i = 0; i < sorted.size(); i++)
+    sum += sorted[i];
+  if (sorted.empty() || stats.count != sorted.size() || stats.min != sorted.front() || stats.max != sorted.back() ||
+      stats.sum != sum)
+  {
+    fail("2) count, min, max, or sum wrong", stats.count, (unsigned long)sorted.size());
+    return;
+  }
+  static const uint16_t PER_MILLES[] = {1, 100, 500, 900, 990, 999, 1000};
+  for (uint8_t i = 0; i < sizeof(PER_MILLES)/sizeof(PER_MILLES[0]); i++)
+  {
+    uint32_t threshold = (uint32_t)((sorted.size()*PER_MILLES[i] + 999)/1000);
+    uint16_t expected = sorted[threshold - 1];
+    if (expected >= NUM_BUCKETS - 1) //the last bucket is reported as the max
+      expected = stats.max;
+    if (probe.percentile(source, PER_MILLES[i]) != expected)
+      fail("2) percentile() wrong", PER_MILLES[i], probe.percentile(source, PER_MILLES[i]));
+  }
+}
+
+//7) WideProbe::percentile() of a histogram, vs. the same walk with a 64-bit threshold
+static void check_wide_percentiles(const WideProbe::Stats& stats)
+{
+  uint64_t total = 0;
+  for (uint16_t bucket = 0; bucket < 255; bucket++)
+    total += stats.histogram[bucket];
+  static const uint16_t PER_MILLES[] = {0, 1, 100, 500, 900, 990, 999, 1000};
+  for (uint8_t i = 0; i < sizeof(PER_MILLES)/sizeof(PER_MILLES[0]); i++)
+  {
+    uint64_t threshold = std::max((total*PER_MILLES[i] + 999)/1000, (uint64_t)1);
+    uint16_t expected = stats.max;
+    uint64_t cumulative = 0;
+    for (uint16_t bucket = 0; bucket < 255 - 1; bucket++)
+    {
+      cumulative += stats.histogram[bucket];
+      if (cumulative >= threshold)
+      {
+        expected = bucket;
+        break;
+      }
+    }
+    if (WideProbe::percentile(stats, PER_MILLES[i]) != expected)
+      fail("7) percentile() wrong with saturated buckets", PER_MILLES[i], WideProbe::percentile(stats, PER_MILLES[i]));
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  uint32_t iterations = argc > 1 ? (uint32_t)atol(argv[1]) : 300000;
+  uint64_t seed = argc > 2 ? (uint64_t)atoll(argv[2]) : 1;
+  printf("latency_probe_fuzz: %u iterations per source, seed %llu\n", iterations, (unsigned long long)seed);
+
+  Timer2Sim::begin(8, seed);
+  Counter::setup();
+  Timer2Sim::set_interrupts(true);
+  Timer2Sim::random_cycles(1, 4);
+  probe.start(SOURCE_IDLE, INTERVAL_COUNTS);
+  Timer2Sim::sync();
+  uint64_t start = Timer2Sim::get_true_count();
+
+  for (uint8_t source = 0; source < NUM_SOURCES; source++)
+  {
+    probe.set_source(source);
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+      probe.service();
+      if (source == SOURCE_BURSTS && Timer2Sim::random(5) == 0)
+      {
+        uint8_t SREG_old = SREG;
+        cli();
+        Timer2Sim::sync();
+        uint64_t off = Timer2Sim::get_true_count();
+        uint32_t accesses = Timer2Sim::random(MAX_BURST_ACCESSES);
+        for (uint32_t k = 0; k < accesses; k++)
+        {
+          uint8_t tcnt = TCNT2;
+          (void)tcnt;
+        }
+        Timer2Sim::sync();
+        burst_start = off;
+        burst_end = Timer2Sim::get_true_count();
+        if (burst_end - burst_start > longest_burst)
+          longest_burst = (uint32_t)(burst_end - burst_start);
+        SREG = SREG_old;
+      }
+      else
+        (void)Counter::get_count();
+    }
+  }
+  probe.stop();
+  Timer2Sim::sync();
+  uint64_t stopped = Timer2Sim::get_true_count();
+  while (Timer2Sim::get_true_count() - stopped < 256) //a probe already set still completes
+  {
+    (void)Counter::get_count();
+    Timer2Sim::sync();
+  }
+  uint64_t elapsed = Timer2Sim::get_true_count() - start;
+
+  //2)
+  for (uint8_t source = 0; source < NUM_SOURCES; source++)
+    check_stats(source);
+
+  //3)
+  unsigned long probes = (unsigned long)(latencies[SOURCE_IDLE].size() + latencies[SOURCE_BURSTS].size());
+  unsigned long expected_probes = (unsigned long)(elapsed/INTERVAL_COUNTS);
+  if (probes*10 < expected_probes*9 || probes*10 > expected_probes*11)
+    fail("3) not 1 probe per interval, on average", probes, expected_probes);
+
+  Probe::Stats idle, bursts;
+  probe.get_stats(SOURCE_IDLE, idle);
+  probe.get_stats(SOURCE_BURSTS, bursts);
+  printf("idle: %u probes, min %u, p50 %u, p99 %u, max %u; bursts (up to %u counts): %u probes, min %u, p50 %u, p99 %u, "
+         "max %u\n", idle.count, idle.min, probe.percentile(SOURCE_IDLE, 500), probe.percentile(SOURCE_IDLE, 990), idle.max,
+         longest_burst, bursts.count, bursts.min, probe.percentile(SOURCE_BURSTS, 500), probe.percentile(SOURCE_BURSTS, 990),
+         bursts.max);
+  printf("%lu probes in %llu counts: 1 per %llu counts (interval %u)\n", probes, (unsigned long long)elapsed,
+         (unsigned long long)(probes ? elapsed/probes : 0), INTERVAL_COUNTS);
+
+  //4)
+  probe.set_correction_to_min(SOURCE_IDLE);
+  if (probe.get_correction(SOURCE_IDLE) != idle.min)
+    fail("4) set_correction_to_min() didn't set the minimum", probe.get_correction(SOURCE_IDLE), idle.min);
+  if (probe.correct(SOURCE_IDLE, 1000) != 1000UL - idle.min)
+    fail("4) correct() didn't subtract the correction", probe.correct(SOURCE_IDLE, 1000), 1000 - idle.min);
+
+  //5) 70000 more of 1 latency fills its bucket, which halves them all; it must then be the median, & the max unchanged
+  for (uint32_t i = 0; i < 70000; i++)
+    probe.record(SOURCE_BURSTS, 3);
+  Probe::Stats after;
+  probe.get_stats(SOURCE_BURSTS, after);
+  if (probe.percentile(SOURCE_BURSTS, 500) != 3 || after.max != bursts.max || after.count != bursts.count + 70000)
+    fail("5) the percentiles or max went wrong when the histogram was halved", probe.percentile(SOURCE_BURSTS, 500), after.max);
+
+  //6)
+  if (bursts.max <= idle.max + longest_burst/2)
+    fail("6) the bursts didn't show up in SOURCE_BURSTS' max", bursts.max, idle.max);
+
+  //7) every bucket full (total = 255*65535, so total*1000 > 2^32), then all full but 1 bucket in the middle empty
+  WideProbe::Stats wide;
+  wide.count = 255UL*0xFFFF;
+  wide.min = 0;
+  wide.max = 300;
+  wide.sum = 0;
+  for (uint16_t bucket = 0; bucket < 255; bucket++)
+    wide.histogram[bucket] = 0xFFFF;
+  check_wide_percentiles(wide);
+  wide.histogram[127] = 0;
+  check_wide_percentiles(wide);
+
+  //8) mask the next probe's interrupt, as another library might, & keep calling service()
+  if (probe.get_missed_count() != 0)
+    fail("8) probes missed in the main run, where none should be", probe.get_missed_count(), 0);
+  size_t recorded = latencies[SOURCE_IDLE].size();
+  probe.set_source(SOURCE_IDLE);
+  probe.start(SOURCE_IDLE, INTERVAL_COUNTS);
+  while (!(TIMSK2.hw_read() & _BV(OCIE2B)))
+  {
+    probe.service();
+    (void)Counter::get_count();
+  }
+  TIMSK2.hw_write(TIMSK2.hw_read() & ~_BV(OCIE2B));
+  Timer2Sim::sync();
+  uint64_t masked = Timer2Sim::get_true_count();
+  while (probe.get_missed_count() == 0 && Timer2Sim::get_true_count() - masked < 4096)
+  {
+    probe.service();
+    (void)Counter::get_count();
+    Timer2Sim::sync();
+  }
+  uint64_t given_up = Timer2Sim::get_true_count() - masked;
+  if (probe.get_missed_count() != 1 || given_up < 256 || given_up > (Probe::MISSED_OVERFLOWS + 1)*256UL)
+    fail("8) the masked probe wasn't given up on, or not 1 to MISSED_OVERFLOWS + 1 overflow periods late",
+         probe.get_missed_count(), (unsigned long)given_up);
+  if (latencies[SOURCE_IDLE].size() != recorded)
+    fail("8) the masked probe recorded a latency", (unsigned long)latencies[SOURCE_IDLE].size(), (unsigned long)recorded);
+  while (latencies[SOURCE_IDLE].size() == recorded && Timer2Sim::get_true_count() - masked < 8192)
+  {
+    probe.service();
+    (void)Counter::get_count();
+    Timer2Sim::sync();
+  }
+  if (latencies[SOURCE_IDLE].size() == recorded)
+    fail("8) no probe went off after the masked one was given up on", (unsigned long)recorded, 0);
+  probe.stop();
+  printf("masked probe given up on after %llu counts; missed probes = %u\n", (unsigned long long)given_up,
+         probe.get_missed_count());
+  if (Timer2Sim::get_hw_lost_overflows())
+    fail("overflows lost", (unsigned long)Timer2Sim::get_hw_lost_overflows(), 0);
+
+  printf("%lu failures\n", failures);
+  printf(failures ? "FAIL\n" : "PASS\n");
+  return failures ? 1 : 0;
+}
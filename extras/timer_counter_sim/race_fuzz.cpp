@@ -0,0 +1,369 @@
+/*
+race_fuzz.cpp
+-host (PC) race-fuzzing harness for the overflow handling in TimerCounter<2,...> (the "timer2" object): get_count(),
+ get_count_in_isr(), get_count64(), reset(), & the overflow ISR, all run against the Timer2 simulation in timer_counter_sim.h
+-phase 1, exhaustive: for each call, & each starting state (TCNT2 about to overflow, with & without an overflow already pending,
+ with the overflow count about to carry, etc.), one timer tick (an overflow) is put at EVERY instruction boundary of the call in
+ turn, including the boundaries inside any overflow ISR it triggers
+-phase 2, random: millions of randomly interleaved calls, idle stretches, interrupts-off stretches, & resets, with a random # of
+ CPU cycles at each boundary
+-checked after every call:
+ 1) correct: the count returned lies between the true count just before the call & just after it
+ 2) monotonic: each main-code count is >= the one before it (until a reset())
+ 3) no lost or double-counted overflow: overflow count + TCNT2 + any pending overflow == the true count
+-phase 3, self-test: phase 1 is re-run on a deliberately broken get_count() (it reads the overflow count BEFORE TCNT2 & ignores
+ TOV2: the 127.5us bug described in eRCaGuy_Timer2_Counter.cpp), which MUST fail, to prove the harness can see the bug.
+-finally it reports throughput: calls per wall-clock second, & get_count() calls per SIMULATED second (F_CPU / the simulated
+ cycles per call).
+
+Build & run (Linux/Mac, from the library's root folder):
+  g++ -std=gnu++11 -O2 -Wall -I. -Iextras/timer_counter_sim extras/timer_counter_sim/race_fuzz.cpp -o race_fuzz
+  ./race_fuzz [random iterations, default 2000000] [seed, default 1]
+Exit status: 0 if every check passed (& the self-test caught the broken version), 1 otherwise.
+
+Written: 16 Oct. 2026
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#include "eRCaGuy_TimerCounter.h"
+#include "timer_counter_sim.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+typedef TimerCounter<2,8> Counter;
+
+TIMER_COUNTER_OVF_ISR(2)
+
+//---------------------------------------------------------------------------------------------------
+//The calls under test
+//---------------------------------------------------------------------------------------------------
+enum Op { OP_GET_COUNT, OP_GET_COUNT_IN_ISR, OP_GET_COUNT64, OP_RESET, OP_IDLE, OP_BROKEN_GET_COUNT, NUM_OPS };
+static const char* const OP_NAMES[NUM_OPS] =
+  {"get_count()", "get_count_in_isr()", "get_count64()", "reset()", "idle (ISR only)", "broken get_count()"};
+
+//the 127.5us bug: overflow count read first, then TCNT2, with no check of TOV2
+static uint32_t broken_get_count()
+{
+  uint8_t SREG_old = SREG;
+  cli();
+  uint32_t overflow_count = TimerCounterState<2>::overflow_count;
+  uint8_t tcnt = TCNT2;
+  SREG = SREG_old;
+  return overflow_count*256 + tcnt;
+}
+
+//main code which doesn't touch the counter, so only the ISR does; each read is one boundary
+static void idle(uint32_t num_boundaries)
+{
+  for (uint32_t i = 0; i < num_boundaries; i++)
+    (void)(uint8_t)PINB;
+}
+
+struct Result
+{
+  uint64_t count; //what the call returned (0 for reset() & idle)
+  uint64_t t_start; //the true count just before the call
+  uint64_t t_end; //& just after
+};
+
+//run one call; interrupts are on, as in loop(), except for get_count_in_isr(), which runs with them off, as in another ISR
+static Result run_op(Op op)
+{
+  Result result = {0, 0, 0};
+  Timer2Sim::sync();
+  result.t_start = Timer2Sim::get_true_count();
+  switch (op)
+  {
+    case OP_GET_COUNT: result.count = Counter::get_count(); break;
+    case OP_GET_COUNT_IN_ISR:
+      Timer2Sim::set_interrupts(false);
+      result.count = Counter::get_count_in_isr();
+      Timer2Sim::set_interrupts(true);
+      break;
+    case OP_GET_COUNT64: result.count = Counter::get_count64(); break;
+    case OP_RESET: Counter::reset(); break;
+    case OP_IDLE: idle(12); break;
+    case OP_BROKEN_GET_COUNT: result.count = broken_get_count(); break;
+    default: break;
+  }
+  Timer2Sim::sync();
+  result.t_end = Timer2Sim::get_true_count();
+  return result;
+}
+
+//---------------------------------------------------------------------------------------------------
+//Checks
+//---------------------------------------------------------------------------------------------------
+struct Stats
+{
+  uint64_t runs;
+  uint64_t failures;
+};
+
+static Stats stats[NUM_OPS];
+static unsigned long num_failures_printed = 0;
+
+static void fail(Op op, const char* what, const Result& result, const char* context)
+{
+  stats[op].failures++;
+  if (num_failures_printed++ < 10)
+    printf("  FAIL %s: %s; returned %llu, true count %llu..%llu (%s)\n", OP_NAMES[op], what, (unsigned long long)result.count,
+           (unsigned long long)result.t_start, (unsigned long long)result.t_end, context);
+}
+
+//check 1) & 3); returns false on failure
+static bool check(Op op, const Result& result, const char* context)
+{
+  stats[op].runs++;
+  bool ok = true;
+  if (op == OP_GET_COUNT || op == OP_GET_COUNT_IN_ISR || op == OP_BROKEN_GET_COUNT)
+  {
+    //32-bit: compare mod 2^32
+    uint32_t offset = (uint32_t)result.count - (uint32_t)result.t_start;
+    if (offset > result.t_end - result.t_start)
+    {
+      fail(op, "count outside the call's true time span", result, context);
+      ok = false;
+    }
+  }
+  else if (op == OP_GET_COUNT64)
+  {
+    if (result.count < result.t_start || result.count > result.t_end)
+    {
+      fail(op, "count outside the call's true time span", result, context);
+      ok = false;
+    }
+  }
+  if (!Timer2Sim::in_isr() && Timer2Sim::hw_count() != Timer2Sim::get_true_count())
+  {
+    Result state = {Timer2Sim::hw_count(), Timer2Sim::get_true_count(), Timer2Sim::get_true_count()};
+    fail(op, "overflow lost or double-counted (returned = overflow count + TCNT2 + pending)", state, context);
+    ok = false;
+  }
+  return ok;
+}
+
+//---------------------------------------------------------------------------------------------------
+//Phase 1: one overflow at every boundary
+//---------------------------------------------------------------------------------------------------
+struct StartState
+{
+  uint16_t overflow_count_hi;
+  uint32_t overflow_count;
+  uint8_t tcnt;
+  bool tov_pending;
+};
+
+static const StartState START_STATES[] =
+{
+  {0, 0x00012345UL, 255, false}, //about to overflow
+  {0, 0x00012345UL, 255, true}, //about to overflow, with one already pending
+  {0, 0xFFFFFFFFUL, 255, false}, //about to carry into overflow_count_hi
+  {0, 0xFFFFFFFEUL, 255, true}, //the pending overflow makes it 0xFFFFFFFF, the next one carries
+  {3, 0xFFFFFFFFUL, 255, false}, //carries into a non-zero overflow_count_hi
+};
+static const uint8_t NUM_START_STATES = sizeof(START_STATES)/sizeof(START_STATES[0]);
+
+static void start(const StartState& state)
+{
+  Timer2Sim::begin(8);
+  TIMSK2.hw_write(_BV(TOIE2));
+  Timer2Sim::set_interrupts(true);
+  Timer2Sim::set_state(state.overflow_count_hi, state.overflow_count, state.tcnt, state.tov_pending);
+}
+
+//returns the # of cases run; cases in which the overflow lands while another is still pending, before any code could have
+//serviced it, are skipped: the hardware itself loses that one (TOV2 is 1 bit), so no software can count it
+static uint64_t exhaustive(Op op, uint64_t& num_skipped)
+{
+  uint64_t num_cases = 0;
+  for (uint8_t s = 0; s < NUM_START_STATES; s++)
+  {
+    for (uint32_t k = 0; ; k++)
+    {
+      start(START_STATES[s]);
+      Timer2Sim::tick_at(k);
+      Timer2Sim::reset_boundary_count();
+      Result result = run_op(op);
+      bool ticked = Timer2Sim::get_boundary_count() > k;
+      Timer2Sim::freeze();
+      idle(3); //let any overflow left pending be serviced, so check 3) sees the settled state
+      Timer2Sim::sync();
+      char context[80];
+      snprintf(context, sizeof(context), "start state %u, overflow at boundary %lu", s, (unsigned long)k);
+      if (Timer2Sim::get_hw_lost_overflows())
+        num_skipped++;
+      else
+      {
+        check(op, result, context);
+        num_cases++;
+      }
+      if (!ticked)
+        break; //the call had fewer than k+1 boundaries: every boundary has been covered
+    }
+  }
+  return num_cases;
+}
+
+//---------------------------------------------------------------------------------------------------
+//Phase 2: random interleavings
+//---------------------------------------------------------------------------------------------------
+struct Throughput
+{
+  uint64_t calls; //get_count() family
+  uint64_t call_cycles; //simulated cycles spent inside them
+  double wall_seconds;
+  double sim_seconds;
+};
+
+static Throughput random_fuzz(uint64_t num_iterations, uint64_t seed)
+{
+  Throughput throughput = {0, 0, 0.0, 0.0};
+  Timer2Sim::begin(8, seed);
+  TIMSK2.hw_write(_BV(TOIE2));
+  Timer2Sim::set_interrupts(true);
+  Timer2Sim::random_cycles(1, 4);
+
+  bool have_last = false;
+  bool have_last64 = false;
+  uint32_t last_count = 0;
+  uint64_t last_count64 = 0;
+  char context[80];
+  std::chrono::steady_clock::time_point wall_start = std::chrono::steady_clock::now();
+  for (uint64_t i = 0; i < num_iterations; i++)
+  {
+    snprintf(context, sizeof(context), "random iteration %llu, seed %llu", (unsigned long long)i, (unsigned long long)seed);
+
+    //1 time in 8, fast-forward to just before an overflow, so overflows land inside calls far more often than by chance
+    if (Timer2Sim::random(8) == 0 && !(TIFR2.hw_read() & _BV(TOV2)))
+      Timer2Sim::advance((uint32_t)(255 - TCNT2.hw_read())*8 + Timer2Sim::random(8));
+
+    uint32_t r = Timer2Sim::random(1000);
+    Op op = r < 400 ? OP_GET_COUNT : r < 600 ? OP_GET_COUNT64 : r < 750 ? OP_GET_COUNT_IN_ISR : r < 999 ? OP_IDLE : OP_RESET;
+    uint64_t cycle_start = Timer2Sim::get_cycle();
+    Result result = run_op(op);
+    if (op != OP_IDLE && op != OP_RESET)
+    {
+      throughput.calls++;
+      throughput.call_cycles += Timer2Sim::get_cycle() - cycle_start;
+    }
+    check(op, result, context);
+
+    //monotonic: main-code counts never go backwards (32-bit counts: across a rollover too)
+    if (op == OP_RESET)
+      have_last = have_last64 = false;
+    else if (op == OP_GET_COUNT || op == OP_GET_COUNT64)
+    {
+      uint32_t count = (uint32_t)result.count;
+      if (have_last && (int32_t)(count - last_count) < 0)
+        fail(op, "not monotonic", result, context);
+      last_count = count;
+      have_last = true;
+      if (op == OP_GET_COUNT64)
+      {
+        if (have_last64 && result.count < last_count64)
+          fail(op, "not monotonic", result, context);
+        last_count64 = result.count;
+        have_last64 = true;
+      }
+    }
+
+    //now & then, some interrupts-off time (< 1 overflow period, as any well-behaved ISR or critical section is)
+    if (Timer2Sim::random(16) == 0)
+    {
+      Timer2Sim::set_interrupts(false);
+      idle(1 + Timer2Sim::random(200));
+      Timer2Sim::set_interrupts(true);
+    }
+  }
+  throughput.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+  throughput.sim_seconds = (double)Timer2Sim::get_cycle()/F_CPU;
+  if (Timer2Sim::get_hw_lost_overflows())
+    printf("  NOTE: the hardware lost %llu overflows (interrupts off too long); the harness itself is misconfigured\n",
+           (unsigned long long)Timer2Sim::get_hw_lost_overflows());
+  printf("  %llu overflow ISRs dispatched, %.3f simulated seconds\n", (unsigned long long)Timer2Sim::get_isr_count(),
+         throughput.sim_seconds);
+  return throughput;
+}
+
+//---------------------------------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  uint64_t num_iterations = argc > 1 ? strtoull(argv[1], NULL, 0) : 2000000;
+  uint64_t seed = argc > 2 ? strtoull(argv[2], NULL, 0) : 1;
+  bool ok = true;
+
+  printf("Phase 1: one overflow at every instruction boundary\n");
+  const Op EXHAUSTIVE_OPS[] = {OP_GET_COUNT, OP_GET_COUNT_IN_ISR, OP_GET_COUNT64, OP_RESET, OP_IDLE};
+  for (uint8_t i = 0; i < sizeof(EXHAUSTIVE_OPS)/sizeof(EXHAUSTIVE_OPS[0]); i++)
+  {
+    Op op = EXHAUSTIVE_OPS[i];
+    uint64_t num_skipped = 0;
+    uint64_t num_cases = exhaustive(op, num_skipped);
+    printf("  %-20s %6llu cases, %llu failures (%llu skipped: 2 overflows pending at once)\n", OP_NAMES[op],
+           (unsigned long long)num_cases, (unsigned long long)stats[op].failures, (unsigned long long)num_skipped);
+    if (stats[op].failures)
+      ok = false;
+    stats[op].runs = stats[op].failures = 0; //phase 2 counts from 0
+  }
+
+  printf("Phase 2: %llu random interleavings (seed %llu)\n", (unsigned long long)num_iterations, (unsigned long long)seed);
+  Throughput throughput = random_fuzz(num_iterations, seed);
+  for (uint8_t op = 0; op < OP_BROKEN_GET_COUNT; op++)
+  {
+    printf("  %-20s %10llu runs, %llu failures\n", OP_NAMES[op], (unsigned long long)stats[op].runs,
+           (unsigned long long)stats[op].failures);
+    if (stats[op].failures)
+      ok = false;
+  }
+
+  printf("Phase 3: self-test; a broken get_count() MUST fail\n");
+  num_failures_printed = 10; //don't print the expected failures
+  uint64_t num_skipped = 0;
+  exhaustive(OP_BROKEN_GET_COUNT, num_skipped);
+  printf("  %-20s %6llu runs, %llu failures --> %s\n", OP_NAMES[OP_BROKEN_GET_COUNT],
+         (unsigned long long)stats[OP_BROKEN_GET_COUNT].runs, (unsigned long long)stats[OP_BROKEN_GET_COUNT].failures,
+         stats[OP_BROKEN_GET_COUNT].failures ? "caught, good" : "NOT CAUGHT");
+  if (stats[OP_BROKEN_GET_COUNT].failures == 0)
+    ok = false;
+
+  printf("Throughput:\n");
+  printf("  host: %.0f calls/sec wall clock (%.1f simulated seconds per wall-clock second)\n",
+         throughput.calls/throughput.wall_seconds, throughput.sim_seconds/throughput.wall_seconds);
+  if (throughput.calls)
+  {
+    double cycles_per_call = (double)throughput.call_cycles/throughput.calls;
+    printf("  simulated: %.1f cycles per get_count()-family call --> %.0f calls per simulated second @ %lu Hz\n",
+           cycles_per_call, F_CPU/cycles_per_call, (unsigned long)F_CPU);
+  }
+
+  printf("%s\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
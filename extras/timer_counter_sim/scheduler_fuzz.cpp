@@ -0,0 +1,351 @@
+/*
+scheduler_fuzz.cpp
+-host (PC) fuzzing harness for TimerScheduler (eRCaGuy_TimerScheduler.h), run against the Timer2 simulation in
+ timer_counter_sim.h, with its compare match ISR (channel A) & the overflow ISR dispatched by the simulation as on the AVR
+-random operations from the main code, with interrupts on: schedule_at() at random delays (from "right now" to several trips
+ around the timing wheel), cancel(), re-scheduling (cancel, then schedule_at() a new deadline for the same job), idle
+ stretches, & short interrupts-off stretches
+-random operations from INSIDE the callbacks: scheduling new timers (including already-due ones), cancelling other pending
+ timers, re-scheduling them, & periodic jobs re-scheduling themselves at their own deadline + a period
+-a model of every timer is kept alongside, & checked:
+ 1) each callback runs exactly once, & only if not cancelled; every timer still pending at the end runs when it's drained
+ 2) never early: the count when a callback starts is >= its deadline
+ 3) on time: the count when a callback starts is <= its "due" count + LATE_BOUND_COUNTS + LATE_PER_CALLBACK_COUNTS for
+    each other callback which ran from LATE_WINDOW_COUNTS before its due count until it started (callbacks run one at a time,
+    so timers due close together must wait their turn).  The due count is the deadline, or later if the timer couldn't have
+    run by then: if it was scheduled less than LEAD_COUNTS + MIN_ARM_COUNTS before its deadline (the scheduler then wakes up
+    as soon as it can, MIN_ARM_COUNTS from the schedule_at() call), or if the main code had interrupts off around then (then
+    it's the count at which they came back on).
+ 4) is_pending(), cancel(), & pending_count() agree with the model (checked with interrupts off, so no ISR can run between the
+    scheduler's answer & the model's)
+-handles are only used while the model says the timer is pending, so a stale handle (whose 8-bit generation may have wrapped
+ around) is never used; see handle_t in eRCaGuy_TimerScheduler.h
+
+Build & run (Linux/Mac, from the library's root folder):
+  g++ -std=gnu++11 -O2 -Wall -I. -Iextras/timer_counter_sim extras/timer_counter_sim/scheduler_fuzz.cpp -o scheduler_fuzz
+  ./scheduler_fuzz [random iterations, default 300000] [seed, default 1]
+Exit status: 0 if every check passed, 1 otherwise.
+
+Written: 16 Oct. 2026
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#include "eRCaGuy_TimerCounter.h"
+#include "timer_counter_sim.h"
+#include "eRCaGuy_TimerScheduler.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+typedef TimerCounter<2,8> Counter;
+TIMER_COUNTER_OVF_ISR(2)
+
+typedef TimerScheduler<12, Counter, TIMER_COUNTER_CHANNEL_A, 16> Scheduler;
+Scheduler scheduler;
+TIMER_SCHEDULER_ISR(scheduler, 2, A)
+
+//the lateness bound of check 3), in counts of 0.5us: the compare match ISR's entry & service() (~25 counts, at the simulation's
+//cycles per access), + one overflow ISR which may run first (~8 counts); + each other callback (these do a few scheduler calls
+//each).  Over 300 seeds, the worst seen was 33 counts with no other callbacks in the window, & 66 with 1.
+static const uint32_t LATE_BOUND_COUNTS = 40;
+static const uint32_t LATE_PER_CALLBACK_COUNTS = 40;
+static const uint32_t LATE_WINDOW_COUNTS = Scheduler::LEAD_COUNTS + 8;
+static const uint32_t MIN_NOTICE_COUNTS = Scheduler::LEAD_COUNTS + Scheduler::MIN_ARM_COUNTS;
+
+//---------------------------------------------------------------------------------------------------
+//The model
+//---------------------------------------------------------------------------------------------------
+enum State { PENDING, FIRED, CANCELLED };
+
+struct Job
+{
+  uint32_t scheduled_at; //the count just before schedule_at() was called
+  uint32_t deadline;
+  uint32_t fired_at;
+  Scheduler::handle_t handle;
+  State state;
+  uint32_t period; //0 = one-shot; else it re-schedules itself at deadline + period, "runs_left" more times
+  uint16_t runs_left;
+};
+
+static std::vector<Job> jobs;
+static std::vector<uint32_t> pending; //indices into jobs[] of the timers the model says are pending
+static std::vector<uint32_t> fire_log; //the count at which each callback started, in order
+static uint64_t failures = 0;
+static uint64_t num_fired = 0, num_cancelled = 0, num_rescheduled = 0, num_from_callback = 0;
+static uint32_t main_cli_end = 0; //the count at the end of the main code's last interrupts-off stretch
+static int32_t late_max = 0;
+static uint32_t late_histogram[8]; //lateness beyond the due count: 0-3, 4-7, 8-15, 16-31, 32-63, 64-127, 128-255, 256+ counts
+
+static void fail(const char* what, uint32_t job, int64_t detail)
+{
+  failures++;
+  if (failures <= 20)
+    printf("  FAIL job %u: %s (%lld)\n", job, what, (long long)detail);
+}
+
+static void remove_pending(uint32_t job)
+{
+  for (size_t i = 0; i < pending.size(); i++)
+    if (pending[i] == job)
+    {
+      pending[i] = pending.back();
+      pending.pop_back();
+      return;
+    }
+  fail("not in the model's pending list", job, 0);
+}
+
+static void callback(void* arg);
+
+//the following run with interrupts already off: from a callback, or from main code inside cli()
+
+static void add_in_isr(uint32_t job)
+{
+  Job& j = jobs[job];
+  j.state = PENDING;
+  j.scheduled_at = Counter::get_count_in_isr();
+  j.handle = scheduler.schedule_at(j.deadline, callback, (void*)(uintptr_t)job);
+  if (j.handle == Scheduler::NO_TIMER)
+  {
+    fail("schedule_at() refused a timer with room left", job, scheduler.pending_count());
+    j.state = CANCELLED;
+    return;
+  }
+  pending.push_back(job);
+}
+
+//a new job, "delay" counts from now
+static void schedule_in_isr(uint32_t delay, uint32_t period, uint16_t runs)
+{
+  if (pending.size() >= 12)
+    return;
+  Job j = {0, Counter::get_count_in_isr() + delay, 0, Scheduler::NO_TIMER, PENDING, period, runs};
+  jobs.push_back(j);
+  add_in_isr(jobs.size() - 1);
+}
+
+static void cancel_in_isr(uint32_t job)
+{
+  Job& j = jobs[job];
+  bool was_pending = scheduler.is_pending(j.handle);
+  bool cancelled = scheduler.cancel(j.handle);
+  if (!was_pending || !cancelled)
+    fail("is_pending()/cancel() returned false for a pending timer", job, was_pending);
+  if (scheduler.is_pending(j.handle))
+    fail("still pending after cancel()", job, 0);
+  if (scheduler.cancel(j.handle))
+    fail("cancelled twice", job, 0);
+  j.state = CANCELLED;
+  remove_pending(job);
+  num_cancelled++;
+}
+
+//cancel a pending job, & schedule it again, "delay" counts from now
+static void reschedule_in_isr(uint32_t job, uint32_t delay)
+{
+  cancel_in_isr(job);
+  num_cancelled--;
+  jobs[job].deadline = Counter::get_count_in_isr() + delay;
+  add_in_isr(job);
+  num_rescheduled++;
+}
+
+static uint32_t random_delay()
+{
+  switch (Timer2Sim::random(5))
+  {
+    case 0: return Timer2Sim::random(24); //inside the lead: handled right away
+    case 1: return Timer2Sim::random(300);
+    case 2: return Timer2Sim::random(4096); //within 1 trip around the wheel (16 slots * 256 counts)
+    case 3: return Timer2Sim::random(20000); //several trips around
+    default: return 0; //already due
+  }
+}
+
+static void callback(void* arg)
+{
+  uint32_t now = Counter::get_count_in_isr(); //FIRST
+  uint32_t job = (uint32_t)(uintptr_t)arg;
+  Job& j = jobs[job];
+  if (j.state != PENDING)
+  {
+    fail(j.state == FIRED ? "ran twice" : "ran after being cancelled", job, j.state);
+    return;
+  }
+  if ((int32_t)(now - j.deadline) < 0)
+    fail("ran early, by (counts)", job, (int32_t)(j.deadline - now));
+  else
+  {
+    //check 3): the due count, & the other callbacks which ran from just before it until now
+    uint32_t due = j.deadline;
+    if ((int32_t)(j.scheduled_at + MIN_NOTICE_COUNTS - due) > 0)
+      due = j.scheduled_at + MIN_NOTICE_COUNTS;
+    if ((int32_t)(main_cli_end - (due - LATE_WINDOW_COUNTS)) > 0)
+      due = (int32_t)(main_cli_end - due) > 0 ? main_cli_end : due;
+    int32_t late = (int32_t)(now - due);
+    if (late < 0)
+      late = 0;
+    uint32_t others = 0;
+    for (size_t k = fire_log.size(); k > 0 && (int32_t)(fire_log[k - 1] - (due - LATE_WINDOW_COUNTS)) >= 0; k--)
+      others++;
+    if ((uint32_t)late > LATE_BOUND_COUNTS + LATE_PER_CALLBACK_COUNTS*others)
+      fail("ran too late; counts late, x1000 + # of other callbacks in its window", job, (int64_t)late*1000 + others);
+    if (late > late_max)
+      late_max = late;
+    uint8_t bucket = 0;
+    while (bucket < 7 && (uint32_t)late >= (4U << bucket))
+      bucket++;
+    late_histogram[bucket]++;
+  }
+  fire_log.push_back(now);
+  j.state = FIRED;
+  j.fired_at = now;
+  remove_pending(job);
+  num_fired++;
+
+  //random work of its own, as a callback might do
+  if (j.period && j.runs_left)
+  {
+    Job next = {0, j.deadline + j.period, 0, Scheduler::NO_TIMER, PENDING, j.period, (uint16_t)(j.runs_left - 1)};
+    jobs.push_back(next); //NB: "j" is invalid from here on
+    add_in_isr(jobs.size() - 1);
+    num_from_callback++;
+  }
+  uint32_t r = Timer2Sim::random(100);
+  if (r < 20)
+  {
+    schedule_in_isr(random_delay(), 0, 0);
+    num_from_callback++;
+  }
+  else if (r < 30 && !pending.empty())
+    cancel_in_isr(pending[Timer2Sim::random(pending.size())]);
+  else if (r < 40 && !pending.empty())
+    reschedule_in_isr(pending[Timer2Sim::random(pending.size())], random_delay());
+}
+
+//end an interrupts-off stretch of the main code, noting when, for check 3)
+static void end_main_cli(uint8_t SREG_old)
+{
+  main_cli_end = Counter::get_count_in_isr();
+  SREG = SREG_old;
+}
+
+//check 4), from the main code; the model & the scheduler must agree on which timers are pending
+static void check_pending()
+{
+  uint8_t SREG_old = SREG;
+  cli();
+  if (scheduler.pending_count() != pending.size())
+    fail("pending_count() != the model's", 0, (int64_t)scheduler.pending_count() - (int64_t)pending.size());
+  for (size_t i = 0; i < pending.size(); i++)
+    if (!scheduler.is_pending(jobs[pending[i]].handle))
+      fail("is_pending() false for a pending timer", pending[i], 0);
+  end_main_cli(SREG_old);
+}
+
+//---------------------------------------------------------------------------------------------------
+//Main
+//---------------------------------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  uint64_t num_iterations = argc > 1 ? strtoull(argv[1], NULL, 0) : 300000;
+  uint64_t seed = argc > 2 ? strtoull(argv[2], NULL, 0) : 1;
+  printf("TimerScheduler fuzz: %llu iterations, seed %llu\n", (unsigned long long)num_iterations, (unsigned long long)seed);
+
+  Timer2Sim::begin(8, seed);
+  Counter::setup();
+  Timer2Sim::set_interrupts(true);
+  Timer2Sim::random_cycles(1, 12);
+
+  //a few periodic jobs, from the start
+  for (uint8_t i = 0; i < 3; i++)
+  {
+    uint8_t SREG_old = SREG;
+    cli();
+    schedule_in_isr(500 + 300*i, 1000 + 777*i, 400);
+    SREG = SREG_old;
+  }
+
+  for (uint64_t iteration = 0; iteration < num_iterations; iteration++)
+  {
+    uint32_t r = Timer2Sim::random(1000);
+    uint8_t SREG_old = SREG;
+    if (r < 30) //schedule
+    {
+      cli();
+      schedule_in_isr(random_delay(), 0, 0);
+      end_main_cli(SREG_old);
+    }
+    else if (r < 40) //cancel
+    {
+      cli();
+      if (!pending.empty())
+        cancel_in_isr(pending[Timer2Sim::random(pending.size())]);
+      end_main_cli(SREG_old);
+    }
+    else if (r < 50) //re-schedule
+    {
+      cli();
+      if (!pending.empty())
+        reschedule_in_isr(pending[Timer2Sim::random(pending.size())], random_delay());
+      end_main_cli(SREG_old);
+    }
+    else if (r < 55) //a short interrupts-off stretch, ~2 to 12 counts
+    {
+      cli();
+      for (uint32_t n = Timer2Sim::random(10); n > 0; n--)
+        (void)(uint8_t)PINB;
+      end_main_cli(SREG_old);
+    }
+    else if (r < 60)
+      check_pending();
+    else //idle: each read is one boundary, at which the ISRs can run
+      (void)(uint8_t)PINB;
+  }
+
+  //drain: everything still pending must run
+  for (uint32_t i = 0; i < 100000000 && scheduler.pending_count(); i++)
+    (void)(uint8_t)PINB;
+  check_pending();
+  for (size_t i = 0; i < jobs.size(); i++)
+    if (jobs[i].state == PENDING)
+      fail("never ran", i, (int64_t)jobs[i].deadline);
+  if (Timer2Sim::get_hw_lost_overflows())
+    fail("the simulated hardware lost overflows", 0, (int64_t)Timer2Sim::get_hw_lost_overflows());
+
+  printf("timers: %u, fired %llu, cancelled %llu, re-scheduled %llu, scheduled from a callback %llu\n", (unsigned)jobs.size(),
+         (unsigned long long)num_fired, (unsigned long long)num_cancelled, (unsigned long long)num_rescheduled,
+         (unsigned long long)num_from_callback);
+  printf("lateness (counts): max %d; histogram 0-3: %u, 4-7: %u, 8-15: %u, 16-31: %u, 32-63: %u, 64-127: %u, 128-255: %u, 256+: %u\n",
+         late_max, late_histogram[0], late_histogram[1], late_histogram[2], late_histogram[3], late_histogram[4],
+         late_histogram[5], late_histogram[6], late_histogram[7]);
+  printf(failures ? "FAIL: %llu failures\n" : "PASS\n", (unsigned long long)failures);
+  return failures ? 1 : 0;
+}
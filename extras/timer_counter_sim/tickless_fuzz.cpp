@@ -0,0 +1,275 @@
+/*
+tickless_fuzz.cpp
+-host (PC) fuzzing harness for TimerCounterTickless (eRCaGuy_TimerCounter_Tickless.h), run against the Timer2 simulation in
+ timer_counter_sim.h, with its watchdog's compare match ISR (channel B) & the overflow ISR dispatched by the simulation as on the
+ AVR
+-the reference clock (the REFERENCE template parameter) is SimReference, below: us from the simulation's CPU cycle count (16 per
+ us), which keeps running whatever happens to Timer2, just as micros() on Timer0 does on the AVR
+-random rounds of: tight polling; polling gaps with interrupts on, from a few counts to several overflow periods (the watchdog
+ must cover them); polling gaps with interrupts OFF, from under 1 to several overflow periods (the hardware may lose overflows,
+ which must be reported); & now & then exit() & enter(), with some normal (non-tickless) get_count()s in between
+-checks:
+ 1) no wrong counts: every count returned (by get_count_unchecked() or get_count_checked()) is the true count at some moment
+    during the call, less exactly the overflows the HARDWARE lost so far (256 counts each).  So nothing is ever lost or
+    double-counted by the tickless mode itself, & counts are monotonic (except that one the hardware loses may take the count
+    back < 1 period).
+ 2) while polling faster than the watchdog, no ISR runs at all (not the overflow ISR, nor the watchdog)
+ 3) the watchdog: a polling gap (with interrupts on) of more than WATCHDOG_COUNTS + WATCHDOG_SLACK_COUNTS always makes it go off,
+    exactly once; one of less than WATCHDOG_COUNTS never does (no false positives)
+ 4) lost overflows: get_count_checked() returns false & get_lost_overflow_count() is exactly the # the hardware lost, after any
+    interrupts-off gap which lost some (an overflow period is > half a period, so it's always flagged); & it returns true & 0
+    whenever none were lost (no false positives)
+
+Build & run (Linux/Mac, from the library's root folder):
+  g++ -std=gnu++11 -O2 -Wall -I. -Iextras/timer_counter_sim extras/timer_counter_sim/tickless_fuzz.cpp -o tickless_fuzz
+  ./tickless_fuzz [random rounds, default 20000] [seed, default 1]
+Exit status: 0 if every check passed, 1 otherwise.
+
+Written: 16 Oct. 2026
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#include "eRCaGuy_TimerCounter.h"
+#include "timer_counter_sim.h"
+#include "eRCaGuy_TimerCounter_Tickless.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+typedef TimerCounter<2,8> Counter;
+TIMER_COUNTER_OVF_ISR(2)
+
+//the reference clock: us since the simulation began, from its CPU cycles (F_CPU = 16MHz)
+struct SimReference
+{
+  static const bool AVAILABLE = true;
+  static uint32_t micros() { return (uint32_t)(Timer2Sim::get_cycle()/16); }
+};
+
+typedef TimerCounterTickless<Counter, TIMER_COUNTER_CHANNEL_B, SimReference> Tickless;
+Tickless tickless;
+TIMER_COUNTER_TICKLESS_ISR(tickless, 2, B)
+
+//see TimerCounterTickless::WATCHDOG_COUNTS (private): half an overflow period
+static const uint32_t WATCHDOG_COUNTS = Counter::COUNTS_PER_OVERFLOW/2;
+//how late the watchdog ISR may be, once its flag is set during an interrupts-on gap: 1 boundary (at most 12 cycles here), or an
+//overflow ISR first (~8 counts)
+static const uint32_t WATCHDOG_SLACK_COUNTS = 16;
+static const uint32_t PERIOD = Counter::COUNTS_PER_OVERFLOW;
+
+static unsigned long failures = 0;
+
+static void fail(const char* what, unsigned long a, unsigned long b)
+{
+  failures++;
+  if (failures <= 20)
+    printf("  FAIL: %s (%lu, %lu)\n", what, a, b);
+}
+
+static uint32_t true_count()
+{
+  Timer2Sim::sync();
+  return (uint32_t)Timer2Sim::get_true_count();
+}
+
+//the true count, & the overflows the hardware has lost so far, at one moment
+struct Truth
+{
+  uint32_t count;
+  uint32_t hw_lost;
+  Truth() : count(true_count()), hw_lost((uint32_t)Timer2Sim::get_hw_lost_overflows()) {}
+};
+
+//1) "count" must be the true count, less the overflows the hardware has lost, at some moment from "before" to the end of the
+//call (now).  An overflow can even be lost DURING the call (if one was already pending when it began, the next one may come
+//before the call clears the flag), in which case the count may be from either side of that moment.
+static void check_count(uint32_t count, const Truth& before, const char* what)
+{
+  Truth after;
+  uint32_t lowest = before.count - after.hw_lost*PERIOD;
+  uint32_t highest = after.count - before.hw_lost*PERIOD;
+  if (count - lowest > highest - lowest)
+    fail(what, count - lowest, highest - lowest);
+}
+
+static uint32_t last_poll = 0; //the last count returned by tickless.get_count_unchecked()
+static uint32_t last_poll_hw_lost = 0; //& the overflows the hardware had lost by then
+static uint64_t lost_since_clear = 0; //overflows the hardware lost since the last clear_lost_overflow_count()
+static uint64_t hw_lost_old = 0;
+
+static uint32_t poll(const char* what)
+{
+  Truth before;
+  uint32_t count = tickless.get_count_unchecked();
+  check_count(count, before, what);
+  //monotonic, unless the hardware lost an overflow in between: then the count may go back by < 1 period
+  if ((int32_t)(count - last_poll) < 0 && Timer2Sim::get_hw_lost_overflows() == last_poll_hw_lost)
+    fail("1) counts went backward", last_poll, count);
+  last_poll = count;
+  last_poll_hw_lost = (uint32_t)Timer2Sim::get_hw_lost_overflows();
+  return count;
+}
+
+//keep reading TCNT2, with interrupts as they are, for "counts" counts
+static void wait(uint32_t counts)
+{
+  uint32_t start = true_count();
+  while (true_count() - start < counts)
+  {
+    uint8_t tcnt = TCNT2;
+    (void)tcnt;
+  }
+}
+
+//4) the lost overflow report must match the hardware's losses exactly
+static void check_lost()
+{
+  Truth before;
+  uint32_t count;
+  bool ok = tickless.get_count_checked(count);
+  check_count(count, before, "1) get_count_checked() gave a wrong count");
+  last_poll = count;
+  last_poll_hw_lost = (uint32_t)Timer2Sim::get_hw_lost_overflows();
+  uint64_t hw_lost = Timer2Sim::get_hw_lost_overflows(); //including any lost during get_count_checked()
+  lost_since_clear += hw_lost - hw_lost_old;
+  hw_lost_old = hw_lost;
+  uint16_t lost = tickless.get_lost_overflow_count();
+  if (ok != (lost_since_clear == 0))
+    fail(ok ? "4) overflows lost, but get_count_checked() returned true" :
+              "4) no overflows lost, but get_count_checked() returned false", ok, (unsigned long)lost_since_clear);
+  if (lost != lost_since_clear)
+    fail("4) get_lost_overflow_count() isn't the # the hardware lost", lost, (unsigned long)lost_since_clear);
+  if (Timer2Sim::random(2) == 0)
+  {
+    tickless.clear_lost_overflow_count();
+    lost_since_clear = 0;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  uint32_t rounds = argc > 1 ? (uint32_t)atol(argv[1]) : 20000;
+  uint64_t seed = argc > 2 ? (uint64_t)atoll(argv[2]) : 1;
+  printf("tickless_fuzz: %u rounds, seed %llu\n", rounds, (unsigned long long)seed);
+
+  Timer2Sim::begin(8, seed);
+  Counter::setup();
+  Timer2Sim::set_interrupts(true);
+  Timer2Sim::random_cycles(1, 12);
+  tickless.enter();
+  last_poll = poll("1) get_count_unchecked() gave a wrong count");
+
+  unsigned long polls = 0, gaps_tripped = 0, gaps_not_tripped = 0, off_gaps = 0, off_gaps_lost = 0;
+  for (uint32_t round = 0; round < rounds; round++)
+  {
+    uint32_t what = Timer2Sim::random(100);
+    if (what < 40)
+    {
+      //2) tight polling
+      poll("1) get_count_unchecked() gave a wrong count");
+      uint64_t isrs = Timer2Sim::get_isr_count();
+      uint32_t n = 1 + Timer2Sim::random(200);
+      for (uint32_t i = 0; i < n; i++)
+        poll("1) get_count_unchecked() gave a wrong count while polling");
+      polls += n;
+      if (Timer2Sim::get_isr_count() != isrs)
+        fail("2) an ISR ran while polling faster than the watchdog", (unsigned long)(Timer2Sim::get_isr_count() - isrs), n);
+      if (!tickless.is_polling())
+        fail("2) not is_polling() while polling", 0, 0);
+    }
+    else if (what < 75)
+    {
+      //3) a polling gap with interrupts on: short ones around the watchdog's time, long ones up to 6 periods
+      uint32_t gap = Timer2Sim::random(2) ? WATCHDOG_COUNTS - 24 + Timer2Sim::random(48 + WATCHDOG_SLACK_COUNTS) :
+                                            Timer2Sim::random(6*PERIOD);
+      uint16_t watchdog_count = tickless.get_watchdog_count();
+      uint32_t start = poll("1) get_count_unchecked() gave a wrong count");
+      wait(gap);
+      uint32_t end_before = true_count() - (uint32_t)Timer2Sim::get_hw_lost_overflows()*PERIOD;
+      uint32_t end = poll("1) get_count_unchecked() gave a wrong count after a gap");
+      uint16_t went_off = (uint16_t)(tickless.get_watchdog_count() - watchdog_count);
+      if (went_off > 1)
+        fail("3) the watchdog went off more than once in 1 gap", went_off, end - start);
+      if (end_before - start > WATCHDOG_COUNTS + WATCHDOG_SLACK_COUNTS && went_off != 1)
+        fail("3) the watchdog didn't go off in a gap longer than half a period", end - start, went_off);
+      if (end - start < WATCHDOG_COUNTS && went_off != 0)
+        fail("3) the watchdog went off in a gap shorter than half a period", end - start, went_off);
+      if (went_off)
+        gaps_tripped++;
+      else
+        gaps_not_tripped++;
+      if (!tickless.is_polling())
+        fail("3) not is_polling() again, after a gap", 0, 0);
+    }
+    else if (what < 95)
+    {
+      //4) a gap with interrupts off: from under 1 to 6 overflow periods, then maybe a gap with interrupts on, before polling again
+      uint64_t hw_lost = Timer2Sim::get_hw_lost_overflows();
+      if (Timer2Sim::random(2) == 0)
+        poll("1) get_count_unchecked() gave a wrong count");
+      uint8_t SREG_old = SREG;
+      cli();
+      wait(Timer2Sim::random(6*PERIOD));
+      SREG = SREG_old;
+      if (Timer2Sim::random(2) == 0)
+        wait(Timer2Sim::random(3*PERIOD));
+      off_gaps++;
+      if (Timer2Sim::get_hw_lost_overflows() != hw_lost)
+        off_gaps_lost++;
+      check_lost();
+    }
+    else
+    {
+      //exit() & enter(), with normal get_count()s in between
+      tickless.exit();
+      if (tickless.is_active() || !(TIMSK2.hw_read() & _BV(TOIE2)) || (TIMSK2.hw_read() & _BV(OCIE2B)))
+        fail("exit() didn't turn the overflow ISR back on, & the watchdog off", TIMSK2.hw_read(), 0);
+      uint32_t n = Timer2Sim::random(50);
+      for (uint32_t i = 0; i < n; i++)
+      {
+        Truth before;
+        uint32_t count = Counter::get_count();
+        check_count(count, before, "1) a wrong count between exit() & enter()");
+        wait(Timer2Sim::random(2*PERIOD));
+      }
+      tickless.enter();
+      check_lost(); //exit() checked too; anything lost before it is still reported
+    }
+  }
+  check_lost();
+
+  printf("%lu polls; interrupts-on gaps: %lu with the watchdog, %lu without; interrupts-off gaps: %lu, %lu of which lost "
+         "overflows (%llu in all)\n", polls, gaps_tripped, gaps_not_tripped, off_gaps, off_gaps_lost,
+         (unsigned long long)Timer2Sim::get_hw_lost_overflows());
+  if (gaps_tripped == 0 || gaps_not_tripped == 0 || off_gaps_lost == 0 || off_gaps_lost == off_gaps)
+    fail("the random rounds didn't cover every case", gaps_tripped, off_gaps_lost);
+
+  printf("%lu failures\n", failures);
+  printf(failures ? "FAIL\n" : "PASS\n");
+  return failures ? 1 : 0;
+}
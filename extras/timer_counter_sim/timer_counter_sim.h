@@ -0,0 +1,304 @@
+/*
+timer_counter_sim.h
+-a deterministic host (PC) simulation of the ATmega328's Timer2, SREG, & interrupt dispatch, for exercising the library's
+ overflow-race handling (get_count(), reset(), the overflow ISR, etc.) on Linux, with no board & no AVR simulator
+-it plugs into eRCaGuy_TimerCounter_mock.h's access hook: every read or write of a mocked register, & every byte read or written of
+ the library's ISR-shared variables, is one "instruction boundary".  At each boundary the simulation:
+ 1) advances the CPU clock by however many cycles the current time policy says (see below), ticking TCNT2 once every PRESCALER
+    cycles; a tick from 255 to 0 sets TOV2 in TIFR2, & a tick out of TCNT2 == OCR2x sets OCF2x
+ 2) if SREG's I bit is set, & a Timer2 interrupt is both enabled (TIMSK2) & flagged (TIFR2), dispatches it exactly as the AVR does:
+    highest priority (lowest vector #) first, its flag cleared by hardware, I cleared for the ISR's duration & set again by
+    "reti", & at least one more main-code boundary before the next interrupt can be taken
+ ...& then the access itself happens.  So a pending interrupt fires BETWEEN 2 accesses, just as it would between 2 instructions.
+-time policies: FREEZE (no time passes; used to count boundaries), TICK_AT (time is frozen except for exactly one timer tick at
+ boundary # N; used to put an overflow at every boundary of a call in turn), & RANDOM (a seeded random # of cycles per boundary)
+-the simulation also keeps the TRUE count: timer ticks since the count was last set, to check the library's answers against.
+ Any write to TCNT2 re-bases it on the overflow count & the value written, as the library left them; an overflow pending at that
+ moment belongs to the old count (reset() clears it).
+-the overflow ISR's entry & exit (interrupt response, vector jump, register pushes & pops) take ISR_OVERHEAD_CYCLES under the
+ RANDOM policy, on top of the cycles at the ISR's own boundaries.
+
+Limits, by design: only Timer2, in normal mode, with the synchronous (CPU) clock, is modeled; & 1 boundary per register/byte access
+is coarser than real AVR code, which also spends cycles on instructions that touch neither (the RANDOM policy's cycles per
+boundary stand in for those).
+
+Written: 16 Oct. 2026
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#ifndef timer_counter_sim_h
+#define timer_counter_sim_h
+
+#if defined(__AVR__)
+ #error "timer_counter_sim.h is for host (PC) builds only"
+#endif
+
+#include "eRCaGuy_TimerCounter.h"
+
+//Timer2's interrupt vectors; weak, so a harness only needs to define the ISRs it uses.  A vector with no ISR is never dispatched
+//(its flag just stays set), which differs from the AVR, where it would jump to the reset vector.
+extern "C" void TIMER2_COMPA_vect(void) __attribute__((weak));
+extern "C" void TIMER2_COMPB_vect(void) __attribute__((weak));
+extern "C" void TIMER2_OVF_vect(void) __attribute__((weak));
+
+template <int UNUSED = 0>
+class Timer2SimT
+{
+  public:
+    enum TimePolicy { FREEZE, TICK_AT, RANDOM };
+    static const uint8_t ISR_OVERHEAD_CYCLES = 40; //see TIMER_COUNTER_OVF_ISR_CYCLES; the rest is the ISR body's own boundaries
+
+    //start over: all registers 0 (as at power-up), library state 0, true count 0, time frozen; installs the access hook
+    static void begin(uint16_t prescaler = 8, uint64_t seed = 1)
+    {
+      TimerCounterMockIo<>::reset_all();
+      TimerCounterState<2>::overflow_count.hw_write(0);
+      TimerCounterState<2>::overflow_count_hi.hw_write(0);
+      _prescaler = prescaler;
+      _rng = seed ? seed : 1;
+      _cycle = 0;
+      _cycles_to_tick = prescaler;
+      _true_count = 0;
+      _boundary = 0;
+      _policy = FREEZE;
+      _tick_at = 0;
+      _min_cycles = 1;
+      _max_cycles = 1;
+      _in_isr = false;
+      _reti_just_done = false;
+      _tcnt_written = false;
+      _isr_count = 0;
+      _hw_lost_overflows = 0;
+      TimerCounterMockHook<>::before_access = on_access;
+    }
+
+    static void end()
+    {
+      TimerCounterMockHook<>::before_access = 0;
+    }
+
+    //---------------------------------------------------------------------------------------------------
+    //Time policies
+    //---------------------------------------------------------------------------------------------------
+    static void freeze() { _policy = FREEZE; }
+    //time stays frozen except for exactly one timer tick, just before the access at boundary # "boundary" (counted from the last
+    //reset_boundary_count())
+    static void tick_at(uint32_t boundary) { _policy = TICK_AT; _tick_at = boundary; }
+    //min_cycles to max_cycles CPU cycles pass at each boundary (uniformly distributed)
+    static void random_cycles(uint8_t min_cycles, uint8_t max_cycles)
+    {
+      _policy = RANDOM;
+      _min_cycles = min_cycles;
+      _max_cycles = max_cycles;
+    }
+
+    static void reset_boundary_count() { _boundary = 0; }
+    static uint32_t get_boundary_count() { return _boundary; }
+
+    //---------------------------------------------------------------------------------------------------
+    //Direct control, with no boundaries; for setting up a test case
+    //---------------------------------------------------------------------------------------------------
+    //set the library's overflow count, TCNT2, & TOV2, & re-base the true count on them
+    static void set_state(uint16_t overflow_count_hi, uint32_t overflow_count, uint8_t tcnt, bool tov_pending)
+    {
+      TimerCounterState<2>::overflow_count_hi.hw_write(overflow_count_hi);
+      TimerCounterState<2>::overflow_count.hw_write(overflow_count);
+      TCNT2.hw_write(tcnt);
+      TIFR2.hw_write(tov_pending ? (uint8_t)(TIFR2.hw_read() | _BV(TOV2)) : (uint8_t)(TIFR2.hw_read() & ~_BV(TOV2)));
+      _true_count = hw_count();
+      _tcnt_written = false;
+    }
+
+    static void set_interrupts(bool enabled)
+    {
+      SREG.hw_write(enabled ? (uint8_t)(SREG.hw_read() | _BV(SREG_I)) : (uint8_t)(SREG.hw_read() & ~_BV(SREG_I)));
+    }
+
+    //let "cycles" CPU cycles pass with no code running (TCNT2 ticks, flags get set, but nothing is dispatched until the next
+    //boundary)
+    static void advance(uint32_t cycles)
+    {
+      for (uint32_t i = 0; i < cycles; i++)
+        step_cycle();
+    }
+
+    //finish any pending re-base; call after a library call returns, before using get_true_count()
+    static void sync()
+    {
+      if (_tcnt_written)
+      {
+        _true_count = hw_count(false);
+        _tcnt_written = false;
+      }
+    }
+
+    //---------------------------------------------------------------------------------------------------
+    //Observations
+    //---------------------------------------------------------------------------------------------------
+    //the true # of timer ticks, 64 bits; compare its low 32 bits with get_count()
+    static uint64_t get_true_count() { return _true_count; }
+    //the count implied by the library's state & the hardware right now: overflow count, + TCNT2, + 1 overflow if TOV2 is pending.
+    //If nothing has been lost or double-counted, this always equals get_true_count() (once sync()ed).
+    static uint64_t hw_count(bool include_pending = true)
+    {
+      uint64_t overflows = ((uint64_t)TimerCounterState<2>::overflow_count_hi.hw_read() << 32) |
+                           TimerCounterState<2>::overflow_count.hw_read();
+      if (include_pending && (TIFR2.hw_read() & _BV(TOV2)))
+        overflows++;
+      return (overflows << 8) + TCNT2.hw_read();
+    }
+    static uint64_t get_cycle() { return _cycle; }
+    static uint64_t get_isr_count() { return _isr_count; }
+    //overflows the HARDWARE lost, ie: TCNT2 overflowed again while TOV2 was still set.  Only code which keeps interrupts off for
+    //more than an overflow period can cause this, so a test which doesn't do that should always see 0.
+    static uint64_t get_hw_lost_overflows() { return _hw_lost_overflows; }
+    static bool in_isr() { return _in_isr; }
+
+    //a seeded xorshift64* random # generator, for the harness & the RANDOM policy; the same seed always gives the same run
+    static uint64_t random()
+    {
+      _rng ^= _rng >> 12;
+      _rng ^= _rng << 25;
+      _rng ^= _rng >> 27;
+      return _rng * 2685821657736338717ULL;
+    }
+    static uint32_t random(uint32_t n) { return (uint32_t)((random() >> 32) % n); } //0 to n-1
+
+  private:
+    static void step_cycle()
+    {
+      _cycle++;
+      if (--_cycles_to_tick == 0)
+      {
+        _cycles_to_tick = _prescaler;
+        tick();
+      }
+    }
+
+    //one timer clock: see datasheet pg. 145-147 (normal mode)
+    static void tick()
+    {
+      uint8_t tcnt = TCNT2.hw_read();
+      uint8_t flags = TIFR2.hw_read();
+      if (tcnt == OCR2A.hw_read())
+        flags |= _BV(OCF2A);
+      if (tcnt == OCR2B.hw_read())
+        flags |= _BV(OCF2B);
+      tcnt++;
+      if (tcnt == 0)
+      {
+        if (flags & _BV(TOV2))
+          _hw_lost_overflows++;
+        flags |= _BV(TOV2);
+      }
+      TCNT2.hw_write(tcnt);
+      TIFR2.hw_write(flags);
+      _true_count++;
+    }
+
+    static void on_access(const void* address, bool is_write)
+    {
+      sync(); //a TCNT2 write at the previous boundary has now taken effect
+
+      if (_policy == TICK_AT)
+      {
+        if (_boundary == _tick_at)
+          advance(_cycles_to_tick); //exactly one tick
+      }
+      else if (_policy == RANDOM)
+        advance(_min_cycles + random(_max_cycles - _min_cycles + 1));
+      _boundary++;
+
+      if (_reti_just_done)
+        _reti_just_done = false; //the AVR always executes 1 more main-code instruction after "reti"
+      else if (!_in_isr && (SREG.hw_read() & _BV(SREG_I)))
+        dispatch();
+
+      if (is_write && address == &TCNT2)
+        _tcnt_written = true;
+    }
+
+    static void dispatch()
+    {
+      uint8_t pending = TIFR2.hw_read() & TIMSK2.hw_read();
+      void (*isr)(void) = 0;
+      uint8_t flag = 0;
+      if ((pending & _BV(OCF2A)) && TIMER2_COMPA_vect) { isr = TIMER2_COMPA_vect; flag = OCF2A; }
+      else if ((pending & _BV(OCF2B)) && TIMER2_COMPB_vect) { isr = TIMER2_COMPB_vect; flag = OCF2B; }
+      else if ((pending & _BV(TOV2)) && TIMER2_OVF_vect) { isr = TIMER2_OVF_vect; flag = TOV2; }
+      if (!isr)
+        return;
+      TIFR2.hw_write(TIFR2.hw_read() & ~_BV(flag)); //cleared by hardware when the vector is taken
+      set_interrupts(false);
+      _in_isr = true;
+      _isr_count++;
+      if (_policy == RANDOM)
+        advance(ISR_OVERHEAD_CYCLES/2);
+      isr();
+      if (_policy == RANDOM)
+        advance(ISR_OVERHEAD_CYCLES - ISR_OVERHEAD_CYCLES/2);
+      _in_isr = false;
+      set_interrupts(true); //reti
+      _reti_just_done = true;
+    }
+
+    static uint16_t _prescaler;
+    static uint64_t _rng;
+    static uint64_t _cycle;
+    static uint16_t _cycles_to_tick;
+    static uint64_t _true_count;
+    static uint32_t _boundary;
+    static TimePolicy _policy;
+    static uint32_t _tick_at;
+    static uint8_t _min_cycles;
+    static uint8_t _max_cycles;
+    static bool _in_isr;
+    static bool _reti_just_done;
+    static bool _tcnt_written;
+    static uint64_t _isr_count;
+    static uint64_t _hw_lost_overflows;
+};
+template <int UNUSED> uint16_t Timer2SimT<UNUSED>::_prescaler = 8;
+template <int UNUSED> uint64_t Timer2SimT<UNUSED>::_rng = 1;
+template <int UNUSED> uint64_t Timer2SimT<UNUSED>::_cycle = 0;
+template <int UNUSED> uint16_t Timer2SimT<UNUSED>::_cycles_to_tick = 8;
+template <int UNUSED> uint64_t Timer2SimT<UNUSED>::_true_count = 0;
+template <int UNUSED> uint32_t Timer2SimT<UNUSED>::_boundary = 0;
+template <int UNUSED> typename Timer2SimT<UNUSED>::TimePolicy Timer2SimT<UNUSED>::_policy = Timer2SimT<UNUSED>::FREEZE;
+template <int UNUSED> uint32_t Timer2SimT<UNUSED>::_tick_at = 0;
+template <int UNUSED> uint8_t Timer2SimT<UNUSED>::_min_cycles = 1;
+template <int UNUSED> uint8_t Timer2SimT<UNUSED>::_max_cycles = 1;
+template <int UNUSED> bool Timer2SimT<UNUSED>::_in_isr = false;
+template <int UNUSED> bool Timer2SimT<UNUSED>::_reti_just_done = false;
+template <int UNUSED> bool Timer2SimT<UNUSED>::_tcnt_written = false;
+template <int UNUSED> uint64_t Timer2SimT<UNUSED>::_isr_count = 0;
+template <int UNUSED> uint64_t Timer2SimT<UNUSED>::_hw_lost_overflows = 0;
+
+typedef Timer2SimT<> Timer2Sim;
+
+#endif
@@ -0,0 +1,262 @@
+/*
+timestamp_stream_decoder.cpp
+-host (PC) decoder for the binary frames written by TimestampStreamEncoder; see eRCaGuy_TimestampStream.h for the format
+-reads the raw byte stream from a file, or from stdin, & writes the decoded values to stdout, as CSV (the default) or as raw
+ little-endian uint32_t values
+-at the end (& every time frames or values are lost), it reports to stderr: frames & values decoded, frames lost (gaps in the
+ sequence #, which includes frames the Arduino dropped because its transmit queue was full), frames with bad checksums, & the
+ overrun total last sent in a TAG_OVERRUN_COUNT tagged value frame (values the Arduino lost before they reached the encoder, ex:
+ TimestampRingBuffer overruns).  Tagged values with other tags are printed to stderr as they arrive.
+-SEQ is only 8 bits, so each gap is counted mod 256: a burst of 256 or more lost frames in a row is reported as 0 to 255 lost
+
+Build (Linux/Mac, from the library's root folder):
+  g++ -std=c++11 -O2 -Wall -I. extras/timestamp_stream_decoder/timestamp_stream_decoder.cpp -o timestamp_stream_decoder
+
+Usage:
+  timestamp_stream_decoder [--binary] [--edges] [--counts-per-us N] [file]
+  --binary         write each value as 4 raw little-endian bytes instead of CSV
+  --edges          each value is (timestamp << 1) | pin_state, as in the stream_edge_timestamps example; CSV columns become
+                   seq,timestamp,pin_state,us (us = timestamp/counts-per-us).  timestamp is only the low 31 bits of the count,
+                   so it wraps every 2^31 counts (1073.7 sec @ 0.5us/count): add 2^31 each time it goes back.
+  --counts-per-us  timer counts per us, for the "us" column (default 2, ie: 0.5us/count, as for the "timer2" object)
+  file             the captured stream; stdin if omitted
+
+ex: capture straight from the Arduino (Linux):
+  stty -F /dev/ttyUSB0 115200 raw -echo
+  ./timestamp_stream_decoder --edges < /dev/ttyUSB0 > edges.csv
+
+Written: 16 Oct. 2026
+*/
+
+/*
+===================================================================================================
+  LICENSE & DISCLAIMER
+  Copyright (C) 2015 Gabriel Staples.  All right reserved.
+
+  ------------------------------------------------------------------------------------------------
+  License: GNU Lesser General Public License Version 3 (LGPLv3) or later - https://www.gnu.org/licenses/lgpl.html
+  ------------------------------------------------------------------------------------------------
+
+  This file is part of eRCaGuy_Timer2_Counter.
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with this program.  If not, see http://www.gnu.org/licenses/
+===================================================================================================
+*/
+
+#include "eRCaGuy_TimestampStream.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+struct Options
+{
+  bool binary;
+  bool edges;
+  double counts_per_us;
+  const char* filename;
+};
+
+struct Totals
+{
+  unsigned long long frames;
+  unsigned long long values;
+  unsigned long long frames_lost; //gaps in SEQ
+  unsigned long long bad_checksums;
+  unsigned long long bad_payloads; //checksum ok, but the payload didn't hold COUNT varints
+  unsigned long long bytes_skipped; //while searching for SYNC_0, SYNC_1
+  unsigned long long overruns; //the last TAG_OVERRUN_COUNT value received
+};
+
+//read a varint from payload[pos...len-1]; returns false if it runs past the end or is longer than 5 bytes
+static bool varint_decode(const uint8_t* payload, size_t len, size_t& pos, uint32_t& value)
+{
+  value = 0;
+  for (unsigned shift = 0; shift < 35; shift += 7)
+  {
+    if (pos >= len)
+      return false;
+    uint8_t byte = payload[pos++];
+    value |= (uint32_t)(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0)
+      return true;
+  }
+  return false;
+}
+
+static void output_value(const Options& options, uint8_t seq, uint32_t value)
+{
+  if (options.binary)
+  {
+    uint8_t bytes[4] = {(uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24)};
+    fwrite(bytes, 1, 4, stdout);
+  }
+  else if (options.edges)
+  {
+    uint32_t timestamp = value >> 1;
+    printf("%u,%u,%u,%.3f\n", seq, timestamp, value & 1, timestamp/options.counts_per_us);
+  }
+  else
+    printf("%u,%u\n", seq, value);
+}
+
+//decode one frame's payload; returns false (& outputs nothing) if it doesn't hold exactly "count" varints
+static bool decode_payload(const Options& options, uint8_t seq, uint8_t count, const uint8_t* payload, size_t len,
+                           Totals& totals)
+{
+  std::vector<uint32_t> values;
+  size_t pos = 0;
+  uint32_t value = 0;
+  for (unsigned i = 0; i < count; i++)
+  {
+    uint32_t raw;
+    if (!varint_decode(payload, len, pos, raw))
+      return false;
+    value = i == 0 ? raw : value + (uint32_t)TimestampStreamFormat::zigzag_decode(raw); //mod 2^32, like the encoder
+    values.push_back(value);
+  }
+  if (pos != len || count == 0)
+    return false;
+  for (size_t i = 0; i < values.size(); i++)
+    output_value(options, seq, values[i]);
+  totals.values += values.size();
+  return true;
+}
+
+//decode a tagged value frame's payload (TAG, then 1 varint); returns false if it doesn't hold exactly that
+static bool decode_tagged(uint8_t seq, const uint8_t* payload, size_t len, Totals& totals)
+{
+  size_t pos = 1;
+  uint32_t value;
+  if (len < 2 || !varint_decode(payload, len, pos, value) || pos != len)
+    return false;
+  if (payload[0] == TimestampStreamFormat::TAG_OVERRUN_COUNT)
+  {
+    if (value != totals.overruns)
+      fprintf(stderr, "values lost to overruns before seq %u: %llu (total %u)\n", seq,
+              value > totals.overruns ? value - totals.overruns : (unsigned long long)value, value); //went back: a reset
+    totals.overruns = value;
+  }
+  else
+    fprintf(stderr, "tag %u at seq %u: %u\n", payload[0], seq, value);
+  return true;
+}
+
+static void report(const Totals& totals)
+{
+  fprintf(stderr, "frames = %llu, values = %llu, frames lost = %llu (each gap counted mod 256), bad checksums = %llu, "
+                  "bad payloads = %llu, bytes skipped = %llu, overruns = %llu\n", totals.frames, totals.values,
+                  totals.frames_lost, totals.bad_checksums, totals.bad_payloads, totals.bytes_skipped, totals.overruns);
+}
+
+int main(int argc, char* argv[])
+{
+  Options options = {false, false, 2.0, NULL};
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "--binary") == 0)
+      options.binary = true;
+    else if (strcmp(argv[i], "--edges") == 0)
+      options.edges = true;
+    else if (strcmp(argv[i], "--counts-per-us") == 0 && i + 1 < argc)
+      options.counts_per_us = atof(argv[++i]);
+    else if (argv[i][0] != '-' && options.filename == NULL)
+      options.filename = argv[i];
+    else
+    {
+      fprintf(stderr, "usage: %s [--binary] [--edges] [--counts-per-us N] [file]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  FILE* in = stdin;
+  if (options.filename)
+  {
+    in = fopen(options.filename, "rb");
+    if (!in)
+    {
+      perror(options.filename);
+      return 1;
+    }
+  }
+  if (!options.binary)
+    printf(options.edges ? "seq,timestamp,pin_state,us\n" : "seq,value\n");
+
+  //bytes not yet decoded; a frame is at most 5 + 250 + 2 bytes
+  std::vector<uint8_t> buf;
+  Totals totals = {0, 0, 0, 0, 0, 0, 0};
+  bool have_seq = false;
+  uint8_t seq_expected = 0;
+  uint8_t chunk[4096];
+  size_t num_read;
+  while ((num_read = fread(chunk, 1, sizeof(chunk), in)) > 0)
+  {
+    buf.insert(buf.end(), chunk, chunk + num_read);
+    size_t pos = 0;
+    while (true)
+    {
+      //find SYNC_0, SYNC_1
+      while (pos + 1 < buf.size() &&
+             !(buf[pos] == TimestampStreamFormat::SYNC_0 && buf[pos + 1] == TimestampStreamFormat::SYNC_1))
+      {
+        pos++;
+        totals.bytes_skipped++;
+      }
+      if (pos + TimestampStreamFormat::HEADER_SIZE > buf.size())
+        break; //need more bytes
+      uint8_t len = buf[pos + 2];
+      uint8_t seq = buf[pos + 3];
+      uint8_t count = buf[pos + 4];
+      if (len == 0 || len > TimestampStreamFormat::MAX_PAYLOAD)
+      {
+        pos++; //not a real frame; resync just past this SYNC_0
+        totals.bytes_skipped++;
+        continue;
+      }
+      size_t frame_len = TimestampStreamFormat::HEADER_SIZE + len + TimestampStreamFormat::CHECKSUM_SIZE;
+      if (pos + frame_len > buf.size())
+        break; //need more bytes
+      const uint8_t* frame = &buf[pos];
+      uint8_t sum1 = 0, sum2 = 0;
+      TimestampStreamFormat::fletcher16_update(sum1, sum2, frame + 2, TimestampStreamFormat::HEADER_SIZE - 2 + len);
+      if (sum1 != frame[frame_len - 2] || sum2 != frame[frame_len - 1])
+      {
+        totals.bad_checksums++;
+        pos++; //a corrupted frame, or SYNC_0, SYNC_1 inside a payload; resync just past this SYNC_0
+        totals.bytes_skipped++;
+        continue;
+      }
+      const uint8_t* payload = frame + TimestampStreamFormat::HEADER_SIZE;
+      if (!(count == 0 ? decode_tagged(seq, payload, len, totals) : decode_payload(options, seq, count, payload, len, totals)))
+        totals.bad_payloads++;
+      totals.frames++;
+      if (have_seq && seq != seq_expected)
+      {
+        totals.frames_lost += (uint8_t)(seq - seq_expected);
+        fprintf(stderr, "frames lost before seq %u: %u (mod 256)\n", seq, (uint8_t)(seq - seq_expected));
+      }
+      have_seq = true;
+      seq_expected = seq + 1;
+      pos += frame_len;
+    }
+    buf.erase(buf.begin(), buf.begin() + pos);
+  }
+
+  if (in != stdin)
+    fclose(in);
+  fflush(stdout);
+  report(totals);
+  return 0;
+}